@@ -0,0 +1,80 @@
+// Bulk upsert throughput: one transaction per row versus the whole batch in a
+// single transaction through one prepared ON CONFLICT statement.
+//
+//   bulk_bench [rows]        (default: 100000)
+//
+// The per-row baseline is what a client looping over POST /api/products gets;
+// it only runs a slice of the rows since each commit pays for its own sync.
+// The SQL mirrors bulkUpsertProducts() in ProductModel.cpp.
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+static const char* kUpsertSql =
+    "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(sku) DO UPDATE SET name = excluded.name, barcode = excluded.barcode, "
+    "category = excluded.category, stock = excluded.stock, threshold = excluded.threshold, "
+    "price = excluded.price, status = excluded.status, updated_at = CURRENT_TIMESTAMP "
+    "RETURNING id";
+
+// Upserts row i; `round` changes the payload so a second pass really updates
+static bool upsertRow(int i, int round) {
+    std::string n = std::to_string(i);
+    std::string id = "id-" + n + "-" + std::to_string(round), sku = "SKU-" + n, barcode = "BC" + n;
+    std::string name = "Product " + n + " r" + std::to_string(round);
+
+    auto stmt = Database::prepare(kUpsertSql);
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, sku.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, barcode.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, "Bench", -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 6, 10 + round);
+    sqlite3_bind_int(stmt, 7, 5);
+    sqlite3_bind_double(stmt, 8, 9.99);
+    sqlite3_bind_text(stmt, 9, "in-stock", -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_ROW) return false;
+    sqlite3_step(stmt);
+    return true;
+}
+
+static double rowsPerSec(int rows, std::chrono::steady_clock::time_point start) {
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return rows / secs;
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int slice = std::min(rows, 2000);
+
+    std::string path = (std::filesystem::temp_directory_path() / "bulk_bench.db").string();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, 2)) return 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < slice; ++i) {
+        WriteQueue::run([i] { return upsertRow(i, 0); });
+    }
+    std::cout << "transaction per row  " << slice << " rows: " << static_cast<long>(rowsPerSec(slice, start)) << " rows/s\n";
+
+    for (int round = 1; round <= 2; ++round) {
+        start = std::chrono::steady_clock::now();
+        int ok = 0;
+        WriteQueue::run([&] {
+            for (int i = 0; i < rows; ++i) ok += upsertRow(i, round);
+            return true;
+        });
+        std::cout << "single transaction   " << rows << " rows (" << (round == 1 ? "mostly inserts" : "all updates")
+                  << "): " << static_cast<long>(rowsPerSec(ok, start)) << " rows/s\n";
+    }
+
+    Database::release();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    return 0;
+}
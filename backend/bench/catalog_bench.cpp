@@ -0,0 +1,89 @@
+// Read scaling of the Catalog snapshot.
+//
+//   catalog_bench [products] [seconds-per-run]
+//
+// For 1, 2, 4 ... 2x hardware threads, every thread loops over find() plus a
+// category read for the given time; total reads/s should grow with the thread
+// count up to the number of cores. Each run is repeated with a writer thread
+// applying single-row updates (copy-on-write snapshots) the whole time.
+#include "models/Catalog.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static Product makeProduct(int i, int stock) {
+    std::string n = std::to_string(i);
+    return Product{"id-" + n, "Product " + n, "SKU-" + n, "Category " + std::to_string(i % 20), "", "BC" + n,
+                   stock, 10, 9.99, ProductStatus::IN_STOCK};
+}
+
+static double readsPerSec(int threads, int count, double seconds) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < threads; ++t) {
+        readers.emplace_back([&, t] {
+            unsigned x = 12345u + t;
+            uint64_t reads = 0;
+            std::string id;
+            while (!stop.load(std::memory_order_relaxed)) {
+                x = x * 1664525u + 1013904223u;
+                id = "id-" + std::to_string(x % count);
+                Epoch::Guard guard;
+                const CatalogSnapshot* snapshot = Catalog::current();
+                const CatalogEntry* entry = snapshot->find(id);
+                if (!entry || snapshot->categories.empty()) std::cerr << "missing " << id << "\n";
+                ++reads;
+            }
+            total += reads;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& r : readers) r.join();
+    return total / seconds;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 100000;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 1.0;
+
+    std::vector<Product> products;
+    products.reserve(count);
+    for (int i = 0; i < count; ++i) products.push_back(makeProduct(i, i % 100));
+    Catalog::rebuild(products);
+
+    int maxThreads = 2 * std::max(1u, std::thread::hardware_concurrency());
+    std::cout << count << " products, " << std::thread::hardware_concurrency() << " hardware threads\n";
+
+    for (bool withWriter : {false, true}) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> writes{0};
+        std::thread writer;
+        if (withWriter) {
+            writer = std::thread([&] {
+                for (int i = 0; !stop; ++i) {
+                    Catalog::apply("id-" + std::to_string(i % count), makeProduct(i % count, i % 50));
+                    ++writes;
+                }
+            });
+        }
+
+        double single = 0;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            double rate = readsPerSec(threads, count, seconds);
+            if (threads == 1) single = rate;
+            std::cout << (withWriter ? "with writer  " : "read only    ") << threads << " threads: "
+                      << static_cast<long>(rate) << " reads/s (" << rate / single << "x)\n";
+        }
+
+        stop = true;
+        if (writer.joinable()) writer.join();
+        if (withWriter) std::cout << "  " << writes << " snapshot swaps during the run\n";
+    }
+    Epoch::collect();
+    return 0;
+}
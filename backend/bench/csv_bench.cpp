@@ -0,0 +1,123 @@
+// CSV tokenizing throughput: the line/comma splitter the importer used before
+// CsvReader, against CsvReader with scalar and AVX2 classification, on plain
+// and on fully quoted (export-style) input. Then number conversion through a
+// stream against std::from_chars.
+//
+//   csv_bench [rows]      (default: 1000000)
+#include "utils/CsvReader.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string makeCsv(int rows, bool quoted) {
+    std::string csv;
+    csv.reserve(static_cast<size_t>(rows) * 100);
+    auto text = [&](const std::string& s) { csv += quoted ? "\"" + s + "\"," : s + ","; };
+    for (int i = 0; i < rows; ++i) {
+        std::string n = std::to_string(i);
+        text("id-" + n);
+        text(quoted && i % 10 == 0 ? "Product \"\"" + n + "\"\", boxed" : "Product " + n);
+        text("SKU-" + n);
+        text("BC" + n);
+        text("Category " + std::to_string(i % 40));
+        csv += std::to_string(i % 500) + ",10," + std::to_string(i % 1000) + ".99,";
+        text("in-stock");
+        csv.back() = '\n';
+    }
+    return csv;
+}
+
+static std::string_view trim(std::string_view v) {
+    while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back() == ' ' || v.back() == '\t' || v.back() == '\r')) v.remove_suffix(1);
+    return v;
+}
+
+// The importer's splitter before CsvReader: no quoting
+static size_t splitLegacy(std::string_view csv) {
+    std::vector<std::string_view> fields;
+    size_t total = 0;
+    size_t start = 0;
+    while (start < csv.size()) {
+        size_t newline = csv.find('\n', start);
+        size_t end = newline == std::string_view::npos ? csv.size() : newline;
+        std::string_view line = csv.substr(start, end - start);
+        start = end + 1;
+        fields.clear();
+        size_t from = 0;
+        while (true) {
+            size_t comma = line.find(',', from);
+            fields.push_back(trim(line.substr(from, comma == std::string_view::npos ? comma : comma - from)));
+            if (comma == std::string_view::npos) break;
+            from = comma + 1;
+        }
+        total += fields.size();
+    }
+    return total;
+}
+
+static size_t splitReader(std::string_view csv) {
+    CsvReader reader(csv);
+    std::vector<std::string_view> fields;
+    size_t total = 0;
+    while (reader.next(fields)) total += fields.size();
+    return total;
+}
+
+template <typename F>
+static void run(const char* label, const std::string& csv, F split) {
+    // Best of five
+    size_t fields = 0;
+    double seconds = 1e9;
+    for (int i = 0; i < 20; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fields = split(csv);
+        seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::cout << "  " << label << ": " << static_cast<long>(csv.size() / seconds / (1024 * 1024)) << " MiB/s ("
+              << fields << " fields)\n";
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    for (bool quoted : {false, true}) {
+        std::string csv = makeCsv(rows, quoted);
+        std::cout << (quoted ? "quoted" : "plain") << ", " << rows << " rows, " << csv.size() / (1024 * 1024)
+                  << " MiB\n";
+        run("line/comma split (no quoting)", csv, splitLegacy);
+        CsvReader::useIsa(CsvReader::Isa::SCALAR);
+        run("CsvReader scalar", csv, splitReader);
+        CsvReader::useIsa(CsvReader::Isa::AVX2);
+        if (CsvReader::isa() == CsvReader::Isa::AVX2) run("CsvReader avx2", csv, splitReader);
+    }
+
+    std::vector<std::string> numbers;
+    for (int i = 0; i < rows; ++i) numbers.push_back(std::to_string(i % 1000) + ".99");
+    auto time = [&](const char* label, auto parse) {
+        double sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& n : numbers) sum += parse(n);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << label << ": " << static_cast<long>(numbers.size() / seconds) << " values/s (sum " << sum
+                  << ")\n";
+    };
+    std::cout << "numbers\n";
+    time("istringstream", [](const std::string& s) {
+        std::istringstream in(s);
+        double d = 0;
+        in >> d;
+        return d;
+    });
+    time("from_chars", [](const std::string& s) {
+        double d = 0;
+        std::from_chars(s.data(), s.data() + s.size(), d);
+        return d;
+    });
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Read throughput of the SQLite connection pool as worker threads are added.
+//
+//   db_read_bench [rows] [seconds-per-step]
+//
+// Builds a throw-away database in the temp directory, then runs point lookups
+// by barcode from 1, 2, 4, ... threads and prints lookups/sec for each step,
+// once preparing every statement and once through the statement cache.
+#include "db/Database.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool seed(sqlite3* db, int rows) {
+    const char* ddl =
+        "CREATE TABLE IF NOT EXISTS products ("
+        " id TEXT PRIMARY KEY, name TEXT NOT NULL, sku TEXT UNIQUE NOT NULL, barcode TEXT UNIQUE,"
+        " category TEXT, price REAL, stock INTEGER DEFAULT 0, threshold INTEGER DEFAULT 0,"
+        " description TEXT, status TEXT, created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        " updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP);";
+    if (sqlite3_exec(db, ddl, nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(db, "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                           "VALUES (?, ?, ?, ?, 'Bench', ?, 10, 9.99, 'in-stock')", -1, &stmt, nullptr);
+    for (int i = 0; i < rows; ++i) {
+        std::string n = std::to_string(i);
+        std::string id = "id-" + n, name = "Product " + n, sku = "SKU-" + n, barcode = "BC" + n;
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, sku.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, barcode.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 5, i % 100);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+static const char* lookupSql =
+    "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products WHERE barcode = ?";
+
+static void lookupLoop(int rows, bool cached, std::atomic<bool>& stop, std::atomic<long long>& total) {
+    sqlite3* db = Database::get();
+    long long done = 0;
+    unsigned x = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    while (!stop.load(std::memory_order_relaxed)) {
+        x = x * 1664525u + 1013904223u;
+        std::string barcode = "BC" + std::to_string(x % rows);
+
+        if (cached) {
+            auto stmt = Database::prepare(lookupSql);
+            sqlite3_bind_text(stmt, 1, barcode.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) == SQLITE_ROW) ++done;
+        } else {
+            sqlite3_stmt* stmt;
+            sqlite3_prepare_v2(db, lookupSql, -1, &stmt, nullptr);
+            sqlite3_bind_text(stmt, 1, barcode.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) == SQLITE_ROW) ++done;
+            sqlite3_finalize(stmt);
+        }
+    }
+    Database::release();
+    total += done;
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? std::stoi(argv[1]) : 100000;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 2.0;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto path = (std::filesystem::temp_directory_path() / "db_read_bench.db").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + "-wal");
+    std::filesystem::remove(path + "-shm");
+
+    if (!Database::init(path, maxThreads + 1) || !seed(Database::get(), rows)) {
+        std::cerr << "Failed to set up benchmark database" << std::endl;
+        return 1;
+    }
+    Database::release();
+
+    std::cout << "rows=" << rows << "\n";
+    std::cout << "threads\tuncached/sec\tcached/sec\tspeedup\n";
+    double base = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double rate[2];
+        for (int cached = 0; cached < 2; ++cached) {
+            std::atomic<bool> stop{false};
+            std::atomic<long long> total{0};
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back(lookupLoop, rows, cached == 1, std::ref(stop), std::ref(total));
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+            stop = true;
+            for (auto& w : workers) w.join();
+            rate[cached] = total / seconds;
+        }
+
+        if (threads == 1) base = rate[1];
+        std::cout << threads << "\t" << static_cast<long long>(rate[0]) << "\t\t"
+                  << static_cast<long long>(rate[1]) << "\t\t" << rate[1] / base << "x\n";
+    }
+
+    auto stats = Database::statementStats();
+    std::cout << "statement cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+              << stats.prepareNanos / 1000 << " us preparing\n";
+
+    Database::shutdown();
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Products CSV export: the previous export (whole catalog into a vector, then
+// an ostringstream, then copies for the file and the response) against
+// exportProductsCsv streaming from the cursor. Peak RSS growth is measured
+// with the streaming export first, as the process high-water mark only rises.
+// Then ExportCache: what a request costs while the data is unchanged, and
+// after a write. Its files go to exports/ under the working directory.
+//
+//   export_bench [products]      (default: 200000)
+#include "db/Database.h"
+#include "db/DataVersion.h"
+#include "models/ExportCache.h"
+#include "models/ProductExport.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+struct Row {
+    std::string id, name, sku, barcode, category, status;
+    int stock, threshold;
+    double price;
+};
+
+// 0 where getrusage isn't available
+static long peakRssKb() {
+#ifndef _WIN32
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static std::string quoted(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) out += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return out + "\"";
+}
+
+// The export before streaming; returns the response body size
+static size_t bufferedExport(const std::string& file) {
+    std::vector<Row> rows;
+    auto stmt = Database::prepare("SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products");
+    auto text = [&](int col) { return std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, col))); };
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        rows.push_back({text(0), text(1), text(2), text(3), text(4), text(8), sqlite3_column_int(stmt, 5),
+                        sqlite3_column_int(stmt, 6), sqlite3_column_double(stmt, 7)});
+    }
+    std::ostringstream csv;
+    csv << "id,name,sku,barcode,category,stock,threshold,price,status\n";
+    for (const auto& r : rows) {
+        csv << quoted(r.id) << "," << quoted(r.name) << "," << quoted(r.sku) << "," << quoted(r.barcode) << ","
+            << quoted(r.category) << "," << r.stock << "," << r.threshold << "," << r.price << "," << quoted(r.status)
+            << "\n";
+    }
+    std::ofstream(file) << csv.str();
+    std::string body(csv.str());
+    return body.size();
+}
+
+int main(int argc, char** argv) {
+    int products = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    std::string path = (std::filesystem::temp_directory_path() / "export_bench.db").string();
+    std::string file = (std::filesystem::temp_directory_path() / "export_bench.csv").string();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, 4)) return 1;
+
+    sqlite3* db = Database::get();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    {
+        auto stmt = Database::prepare("INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                                      "VALUES (?1, 'Product ' || ?1, 'SKU-' || ?1, 'BC-' || ?1, 'Category \"A\"', ?2, 10, 19.99, 'in-stock')");
+        for (int i = 0; i < products; ++i) {
+            std::string id = "p" + std::to_string(i);
+            sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 2, i % 500);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+    long base = peakRssKb();
+    auto start = std::chrono::steady_clock::now();
+    std::FILE* out = std::fopen(file.c_str(), "wb");
+    ExportReport report;
+    bool ok = exportProductsCsv(out, report);
+    std::fclose(out);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long streamed = peakRssKb();
+    std::cout << "streaming: " << (ok ? "" : "FAILED ") << report.rows << " rows, " << report.bytes / 1024 << " KiB in "
+              << seconds * 1000 << " ms (" << static_cast<long>(report.rows / seconds) << " rows/s), peak RSS +"
+              << streamed - base << " KiB\n";
+
+    start = std::chrono::steady_clock::now();
+    size_t bytes = bufferedExport(file);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "vector + ostringstream: " << bytes / 1024 << " KiB in " << seconds * 1000 << " ms ("
+              << static_cast<long>(products / seconds) << " rows/s), peak RSS +" << peakRssKb() - streamed << " KiB\n";
+
+    std::vector<std::string> artifacts;
+    auto timeCache = [&](const char* label, int requests) {
+        ExportArtifact artifact;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < requests; ++i) ExportCache::productsCsv(artifact);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "cache, " << label << ": " << us / requests << " us per request\n";
+        artifacts.push_back(artifact.path);
+    };
+    timeCache("first request", 1);
+    timeCache("unchanged data", 10000);
+    DataVersion::bump();
+    timeCache("after a write", 1);
+    for (const auto& artifact : artifacts) std::filesystem::remove(artifact);
+
+    Database::release();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    std::filesystem::remove(file);
+    return 0;
+}
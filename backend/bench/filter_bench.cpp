@@ -0,0 +1,80 @@
+// Predicate scans over the catalog: array-of-structs versus ProductColumns
+// with the scalar and AVX2 ColumnFilter kernels.
+//
+//   filter_bench [products] [repeats]
+//
+// The query is "stock < threshold AND price BETWEEN 20 AND 60 AND status =
+// low-stock", the shape of a reorder report.
+#include "models/Catalog.h"
+#include "utils/ColumnFilter.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static Product makeProduct(int i, unsigned r) {
+    std::string n = std::to_string(i);
+    auto status = static_cast<ProductStatus>(r % 3);
+    return Product{"id-" + n, "Product " + n, "SKU-" + n, "Category " + std::to_string(r % 20), "", "BC" + n,
+                   static_cast<int>(r % 100), static_cast<int>((r >> 8) % 50), (r >> 4) % 10000 / 100.0, status};
+}
+
+template <typename Scan>
+static double msPerScan(int repeats, size_t& matches, Scan scan) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) matches = scan();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    std::vector<Product> products;
+    products.reserve(count);
+    unsigned x = 7;
+    for (int i = 0; i < count; ++i) {
+        x = x * 1664525u + 1013904223u;
+        products.push_back(makeProduct(i, x >> 4));
+    }
+    Catalog::rebuild(products);
+
+    Epoch::Guard guard;
+    const CatalogSnapshot* snapshot = Catalog::current();
+    auto build = std::chrono::steady_clock::now();
+    const ProductColumns& cols = snapshot->columns();
+    std::cout << count << " products, columns built in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build).count() << " ms\n";
+
+    size_t matches = 0;
+    double aos = msPerScan(repeats, matches, [&] {
+        size_t n = 0;
+        for (const CatalogEntry* e : snapshot->entries) {
+            const Product& p = e->product;
+            n += p.stock < p.threshold && p.price >= 20 && p.price <= 60 && p.status == ProductStatus::LOW_STOCK;
+        }
+        return n;
+    });
+    std::cout << "array of structs:\t" << aos << " ms/scan (" << matches << " matches)\n";
+
+    auto columnar = [&] {
+        size_t rows = cols.stock.size();
+        ColumnFilter::Mask mask = ColumnFilter::all(rows);
+        ColumnFilter::equals(cols.status.data(), rows, static_cast<uint8_t>(ProductStatus::LOW_STOCK), mask);
+        ColumnFilter::less(cols.stock.data(), cols.threshold.data(), rows, mask);
+        ColumnFilter::between(cols.price.data(), rows, 20.0, 60.0, mask);
+        return ColumnFilter::count(mask);
+    };
+
+    for (auto isa : {ColumnFilter::Isa::SCALAR, ColumnFilter::Isa::AVX2}) {
+        ColumnFilter::useIsa(isa);
+        if (ColumnFilter::isa() != isa) {
+            std::cout << "columns (avx2):\t\tnot supported on this CPU\n";
+            continue;
+        }
+        double ms = msPerScan(repeats, matches, columnar);
+        std::cout << (isa == ColumnFilter::Isa::AVX2 ? "columns (avx2):\t\t" : "columns (scalar):\t")
+                  << ms << " ms/scan (" << matches << " matches)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Picks against one product from many threads: each pick as its own guarded
+// UPDATE through the write queue (what POST .../delta does for a normal
+// product) versus the sharded in-memory counters of a hot product.
+//
+//   hot_bench [threads] [seconds]      (default: 8 2)
+//
+// The direct path mirrors InventoryModel::applyStockDelta.
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include "models/HotStock.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool directPick(const std::string& id) {
+    return WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        sqlite3_exec(db, "INSERT INTO stock_movement_context (kind) VALUES ('pick');", nullptr, nullptr, nullptr);
+        auto stmt = Database::prepare("UPDATE products SET stock = stock - 1 WHERE id = ? AND stock >= 1 RETURNING stock");
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+        bool ok = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_step(stmt);
+        sqlite3_exec(db, "DELETE FROM stock_movement_context;", nullptr, nullptr, nullptr);
+        return ok;
+    });
+}
+
+// Runs `pick` from `threads` threads for `seconds`; returns picks/s
+template <typename Pick>
+static double run(int threads, double seconds, Pick pick, uint64_t& accepted) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) n += pick();
+            Database::release();
+            total += n;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& w : workers) w.join();
+    accepted = total;
+    return total / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int64_t storedStock(const std::string& id) {
+    auto stmt = Database::prepare("SELECT stock FROM products WHERE id = ?");
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+    int64_t stock = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : -1;
+    return stock;
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    const int64_t initial = 100000000;
+
+    std::string path = (std::filesystem::temp_directory_path() / "hot_bench.db").string();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, threads + 4)) return 1;
+    for (const char* id : {"direct", "hot"}) {
+        std::string sql = "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                          "VALUES ('" + std::string(id) + "', 'x', '" + id + "', '" + id + "', 'Bench', " +
+                          std::to_string(initial) + ", 10, 1.0, 'in-stock')";
+        sqlite3_exec(Database::get(), sql.c_str(), nullptr, nullptr, nullptr);
+    }
+    Database::release();
+    WriteQueue::start();
+
+    uint64_t accepted = 0;
+    double direct = run(threads, seconds, [] { return directPick("direct"); }, accepted);
+    std::cout << "direct UPDATE per pick: " << static_cast<long>(direct) << " picks/s\n";
+
+    HotStockOptions options;
+    options.flushInterval = std::chrono::milliseconds(100);
+    HotStock::start(options);
+    HotStock::promote("hot", 1000000);
+    double hot = run(threads, seconds, [] { return HotStock::apply("hot", -1) == HotDeltaResult::APPLIED; }, accepted);
+    HotStock::stop();
+    std::cout << "hot counters:           " << static_cast<long>(hot) << " picks/s (" << threads << " threads)\n";
+
+    int64_t stock = storedStock("hot");
+    std::cout << "hot stored stock " << stock << ", expected " << initial - static_cast<int64_t>(accepted)
+              << (stock == initial - static_cast<int64_t>(accepted) ? " (ok)" : " (MISMATCH)") << "\n";
+
+    // Oversell: a product with 1000 units, far more pickers than stock
+    sqlite3_exec(Database::get(), "UPDATE products SET stock = 1000 WHERE id = 'hot'", nullptr, nullptr, nullptr);
+    Database::release();
+    HotStock::start(options);
+    HotStock::promote("hot", 200);
+    run(threads, 0.5, [] {
+        HotDeltaResult r = HotStock::apply("hot", -1);
+        if (r == HotDeltaResult::EXHAUSTED && HotStock::flush("hot")) r = HotStock::apply("hot", -1);
+        return r == HotDeltaResult::APPLIED;
+    }, accepted);
+    HotStock::stop();
+    std::cout << "1000 units, accepted " << accepted << " picks, stored stock " << storedStock("hot") << "\n";
+
+    Database::release();
+    WriteQueue::stop();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Ledger replay time: full replay versus replay from a snapshot, across thread
+// counts.
+//
+//   ledger_bench [products] [movements]      (default: 10000 500000)
+//
+// Movements are written by the stock triggers in db/Schema.cpp, the same way
+// the delta endpoint writes them.
+#include "db/Database.h"
+#include "models/StockLedger.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Applies `count` random deltas in one transaction
+static void writeMovements(int products, int count, std::mt19937& rng) {
+    sqlite3* db = Database::get();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    auto stmt = Database::prepare("UPDATE products SET stock = stock + ? WHERE id = ?");
+    std::uniform_int_distribution<int> product(0, products - 1), delta(-5, 8);
+    for (int i = 0; i < count; ++i) {
+        std::string id = "p" + std::to_string(product(rng));
+        sqlite3_bind_int(stmt, 1, delta(rng));
+        sqlite3_bind_text(stmt, 2, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+static void timeReplay(const char* label) {
+    for (size_t threads : {1, 2, 4, 8}) {
+        LedgerReplay replay;
+        auto start = std::chrono::steady_clock::now();
+        StockLedger::replay(threads, replay);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << label << " " << replay.movementsReplayed << " movements, " << threads << " threads: " << ms << " ms\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int products = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int movements = argc > 2 ? std::atoi(argv[2]) : 500000;
+
+    std::string path = (std::filesystem::temp_directory_path() / "ledger_bench.db").string();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, 10)) return 1;
+
+    sqlite3* db = Database::get();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    {
+        auto stmt = Database::prepare("INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                                      "VALUES (?1, ?1, ?1, ?1, 'Bench', 100, 10, 1.0, 'in-stock')");
+        for (int i = 0; i < products; ++i) {
+            std::string id = "p" + std::to_string(i);
+            sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+    std::mt19937 rng(42);
+    writeMovements(products, movements, rng);
+    Database::release();
+    timeReplay("full replay    ");
+
+    auto start = std::chrono::steady_clock::now();
+    StockLedger::snapshot();
+    std::cout << "snapshot: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+    writeMovements(products, movements / 10, rng);
+    Database::release();
+    timeReplay("from snapshot  ");
+
+    LedgerReplay replay;
+    std::vector<LedgerDrift> drift;
+    StockLedger::replay(4, replay);
+    StockLedger::compare(replay, drift);
+    std::cout << "drift after replay: " << drift.size() << " products\n";
+
+    Database::release();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    return 0;
+}
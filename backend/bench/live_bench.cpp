@@ -0,0 +1,128 @@
+// Fan-out cost of the live feed.
+//
+//   live_bench [products] [clients] [writes] [writes-per-sec]
+//
+// One writer thread applies single-row stock updates at the given rate while
+// `clients` subscribers receive frames; all of them ack promptly except one,
+// which never acks. Reports what LiveFeed::productWritten costs the writer with
+// and without subscribers, how many events reached a prompt client, and that
+// the stalled client stays bounded (window frames, then resync) instead of
+// slowing writers.
+#include "db/Database.h"
+#include "models/Catalog.h"
+#include "models/LiveFeed.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static Product makeProduct(int i, int stock) {
+    std::string n = std::to_string(i);
+    return Product{"id-" + n, "Product " + n, "SKU-" + n, "Category " + std::to_string(i % 20), "", "BC" + n,
+                   stock, 10, 9.99, deriveStatus(stock, 10)};
+}
+
+static size_t countEvents(const std::string& frame) {
+    size_t n = 0;
+    for (size_t pos = frame.find("\"type\""); pos != std::string::npos; pos = frame.find("\"type\"", pos + 1)) ++n;
+    return n;
+}
+
+// Nanoseconds spent in productWritten per write
+static double runWrites(int count, int writes, double rate, unsigned seed) {
+    using Clock = std::chrono::steady_clock;
+    unsigned x = seed;
+    Clock::duration inFeed{};
+    auto start = Clock::now();
+    for (int w = 0; w < writes; ++w) {
+        x = x * 1664525u + 1013904223u;
+        int i = static_cast<int>(x % count);
+        Product p = makeProduct(i, static_cast<int>((x >> 8) % 200));
+        auto before = Clock::now();
+        LiveFeed::productWritten(p.id, p);
+        inFeed += Clock::now() - before;
+        Catalog::apply(p.id, p);
+        if (rate > 0) std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                                std::chrono::duration<double>((w + 1) / rate)));
+    }
+    return std::chrono::duration<double, std::nano>(inFeed).count() / writes;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int clientCount = argc > 2 ? std::stoi(argv[2]) : 40;
+    int writes = argc > 3 ? std::stoi(argv[3]) : 10000;
+    double rate = argc > 4 ? std::stod(argv[4]) : 2000;
+
+    std::string path = std::filesystem::temp_directory_path().string() + "/live_bench.db";
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, 2)) return 1;
+
+    std::vector<Product> products;
+    products.reserve(count);
+    for (int i = 0; i < count; ++i) products.push_back(makeProduct(i, i % 200));
+    Catalog::rebuild(products);
+
+    LiveFeedOptions options;
+    LiveFeed::start(options);
+
+    double idle = runWrites(count, writes, 0, 1);
+
+    // Acks come from another thread, as they would from a socket
+    struct Subscriber {
+        uint64_t id = 0;
+        std::atomic<uint64_t> lastSeq{0};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> events{0};
+        std::atomic<uint64_t> resyncs{0};
+    };
+    std::vector<Subscriber> subscribers(clientCount);
+    for (auto& s : subscribers) {
+        s.id = LiveFeed::subscribe(
+            [&s](const std::string& frame) {
+                s.frames++;
+                s.events += countEvents(frame);
+                if (frame.find("\"resync\"") != std::string::npos) s.resyncs++;
+                s.lastSeq.store(std::stoull(frame.substr(frame.find(':') + 1)));
+            },
+            [] {});
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread acker([&] {
+        while (!stop.load()) {
+            for (size_t c = 1; c < subscribers.size(); ++c) {
+                if (uint64_t seq = subscribers[c].lastSeq.load()) LiveFeed::acknowledge(subscribers[c].id, seq);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    double busy = runWrites(count, writes, rate, 2);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::this_thread::sleep_for(options.flushInterval * 4);
+    stop = true;
+    acker.join();
+
+    const Subscriber& prompt = subscribers.back();
+    const Subscriber& stalled = subscribers.front();
+    auto stats = LiveFeed::stats();
+    std::cout << count << " products, " << clientCount << " clients, " << writes << " writes in " << seconds << " s\n";
+    std::cout << "writer cost, no clients:   " << idle << " ns/write\n";
+    std::cout << "writer cost, with clients: " << busy << " ns/write\n";
+    std::cout << "prompt client: " << prompt.frames << " frames, " << prompt.events << " events ("
+              << (prompt.frames ? prompt.events / prompt.frames : 0) << " per frame), " << prompt.resyncs << " resyncs\n";
+    std::cout << "stalled client: " << stalled.frames << " frames, " << stalled.resyncs << " resyncs\n";
+    std::cout << "feed: " << stats.events << " events, " << stats.frames << " frames, " << stats.resyncs << " resyncs\n";
+
+    for (auto& s : subscribers) LiveFeed::unsubscribe(s.id);
+    LiveFeed::stop();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// LowStockIndex: cost of a stock update and of reading the top K, per catalog size.
+//
+//   lowstock_bench [k]        (default: 20)
+//
+// For comparison, "full scan" is what answering the same question took
+// without the index: a pass over every product plus a partial sort.
+#include "models/LowStockIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static Product makeProduct(int i, unsigned r) {
+    std::string n = std::to_string(i);
+    return Product{"id-" + n, "Product " + n, "SKU-" + n, "Bench", "", "BC" + n,
+                   static_cast<int>(r % 500), static_cast<int>(1 + (r >> 9) % 50), 9.99, ProductStatus::IN_STOCK};
+}
+
+template <typename Fn>
+static double nsPer(int iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    size_t k = argc > 1 ? std::stoul(argv[1]) : 20;
+
+    for (int count : {10000, 100000, 1000000}) {
+        std::vector<Product> products;
+        products.reserve(count);
+        unsigned x = 99;
+        for (int i = 0; i < count; ++i) {
+            x = x * 1664525u + 1013904223u;
+            products.push_back(makeProduct(i, x >> 4));
+        }
+        LowStockIndex::rebuild(products);
+
+        size_t sink = 0;
+        double topNs = nsPer(10000, [&](int) { sink += LowStockIndex::top(k, 1.0).size(); });
+        double updateNs = nsPer(100000, [&](int i) {
+            x = x * 1664525u + 1013904223u;
+            LowStockIndex::apply(products[i % count].id, makeProduct(i % count, x >> 4));
+        });
+        double scanNs = nsPer(5, [&](int) {
+            std::vector<std::pair<double, const Product*>> low;
+            for (const auto& p : products) {
+                double ratio = static_cast<double>(p.stock) / p.threshold;
+                if (ratio <= 1.0) low.emplace_back(ratio, &p);
+            }
+            size_t n = std::min(k, low.size());
+            std::partial_sort(low.begin(), low.begin() + n, low.end());
+            sink += n;
+        });
+
+        std::cout << count << " products: top " << k << " in " << topNs / 1000 << " us, update in "
+                  << updateNs << " ns, full scan " << scanNs / 1e6 << " ms\n";
+        if (sink == 0) std::cout << "(no low-stock items)\n";
+    }
+    return 0;
+}
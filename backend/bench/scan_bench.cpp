@@ -0,0 +1,107 @@
+// Latency of barcode lookups: BarcodeIndex versus a cached SQLite statement.
+//
+//   scan_bench [products] [lookups]
+//
+// Index lookups copy the pre-encoded JSON, as /api/products/scan does. A
+// second pass repeats them while another thread keeps updating products.
+#include "db/Database.h"
+#include "models/BarcodeIndex.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static Product makeProduct(int i, int stock) {
+    std::string n = std::to_string(i);
+    return Product{"id-" + n, "Product " + n, "SKU-" + n, "Bench", "", "BC" + n, stock, 10, 9.99, ProductStatus::IN_STOCK};
+}
+
+template <typename Lookup>
+static double nsPerLookup(const std::vector<std::string>& keys, Lookup lookup) {
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (const auto& key : keys) found += lookup(key);
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    if (found != keys.size()) std::cerr << "missed " << keys.size() - found << " lookups\n";
+    return elapsed.count() / keys.size();
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int lookups = argc > 2 ? std::stoi(argv[2]) : 1000000;
+
+    std::vector<Product> products;
+    products.reserve(count);
+    for (int i = 0; i < count; ++i) products.push_back(makeProduct(i, i % 100));
+
+    std::vector<std::string> keys;
+    keys.reserve(lookups);
+    unsigned x = 42;
+    for (int i = 0; i < lookups; ++i) {
+        x = x * 1664525u + 1013904223u;
+        keys.push_back("BC" + std::to_string(x % count));
+    }
+
+    auto build = std::chrono::steady_clock::now();
+    BarcodeIndex::rebuild(products);
+    auto buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build).count();
+    std::cout << "index of " << count << " products built in " << buildMs << " ms\n";
+
+    std::string json;
+    auto index = [&json](const std::string& key) { return BarcodeIndex::lookupJson(key, json); };
+    std::cout << "BarcodeIndex:\t\t" << nsPerLookup(keys, index) << " ns/lookup\n";
+
+    // Same lookups while a writer churns through stock updates
+    std::atomic<bool> stop{false};
+    std::atomic<long> writes{0};
+    std::thread writer([&] {
+        for (int i = 0; !stop; ++i) {
+            BarcodeIndex::upsert(makeProduct(i % count, i % 50));
+            ++writes;
+        }
+    });
+    double underWrites = nsPerLookup(keys, index);
+    stop = true;
+    writer.join();
+    std::cout << "BarcodeIndex + writer:\t" << underWrites << " ns/lookup (" << writes << " concurrent upserts)\n";
+
+    // Baseline: the prepared statement getProductByBarcode runs
+    auto path = (std::filesystem::temp_directory_path() / "scan_bench.db").string();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    if (!Database::init(path, 2)) return 1;
+    sqlite3* db = Database::get();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    {
+        auto insert = Database::prepare("INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                                        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, 'in-stock')");
+        for (const auto& p : products) {
+            sqlite3_bind_text(insert, 1, p.id.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 2, p.name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 3, p.sku.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 4, p.barcode.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 5, p.category.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(insert, 6, p.stock);
+            sqlite3_bind_int(insert, 7, p.threshold);
+            sqlite3_bind_double(insert, 8, p.price);
+            sqlite3_step(insert);
+            sqlite3_reset(insert);
+        }
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+    auto sqlite = [](const std::string& key) {
+        auto stmt = Database::prepare("SELECT id, name, sku, barcode, category, stock, threshold, price, status "
+                                      "FROM products WHERE barcode = ?");
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC);
+        return sqlite3_step(stmt) == SQLITE_ROW;
+    };
+    std::cout << "SQLite (cached stmt):\t" << nsPerLookup(keys, sqlite) << " ns/lookup\n";
+
+    Database::release();
+    Database::shutdown();
+    for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Product search latency: LIKE '%q%' scan versus the products_fts index.
+//
+//   search_bench [rows...]        (default: 10000 100000 1000000)
+//
+// For each catalog size a fresh database is seeded with generated products,
+// then both queries run for a set of prefix terms and the mean latency per
+// query is printed. The SQL mirrors ProductModel.cpp.
+#include "db/Database.h"
+#include "db/Schema.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const char* kWords[] = {
+    "steel", "cotton", "wireless", "organic", "compact", "deluxe", "classic", "rugged",
+    "table", "chair", "lamp", "shirt", "cable", "charger", "bottle", "jacket",
+    "red", "blue", "green", "black", "white", "large", "small", "medium"
+};
+static const char* kCategories[] = { "Electronics", "Furniture", "Apparel", "Kitchen", "Outdoor", "Office" };
+
+// The query searchProducts ran before products_fts existed
+static const char* kLikeSql =
+    "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products "
+    "WHERE name LIKE ? OR category LIKE ?";
+static const char* kFtsSql =
+    "WITH hits AS (SELECT rowid, rank FROM products_fts WHERE products_fts MATCH ?1 "
+    "AND (?2 IS NULL OR rank > ?2 OR (rank = ?2 AND rowid > ?3)) ORDER BY rank, rowid LIMIT 200) "
+    "SELECT p.id, p.name, p.sku, p.barcode, p.category, p.stock, p.threshold, p.price, p.status, "
+    "hits.rank, hits.rowid FROM hits JOIN products p ON p.rowid = hits.rowid ORDER BY hits.rank, hits.rowid";
+
+static void seed(int rows) {
+    sqlite3* db = Database::get();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    auto stmt = Database::prepare("INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                                  "VALUES (?, ?, ?, ?, ?, 10, 5, 19.99, 'in-stock')");
+    unsigned x = 12345;
+    auto next = [&x] { x = x * 1664525u + 1013904223u; return x >> 8; };
+    for (int i = 0; i < rows; ++i) {
+        std::string n = std::to_string(i);
+        std::string id = "id-" + n, sku = "SKU-" + n, barcode = "BC" + n;
+        std::string name = std::string(kWords[next() % 8]) + " " + kWords[8 + next() % 8] + " " + kWords[16 + next() % 8] + " " + n;
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, sku.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, barcode.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 5, kCategories[next() % 6], -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+// Mean microseconds per query, stepping every result row
+template <typename Bind>
+static double timeQueries(const char* sql, const std::vector<std::string>& terms, Bind bind) {
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& term : terms) {
+        auto stmt = Database::prepare(sql);
+        bind(stmt.get(), term);
+        while (sqlite3_step(stmt) == SQLITE_ROW) {}
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / terms.size();
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::stoi(argv[i]));
+    if (sizes.empty()) sizes = {10000, 100000, 1000000};
+
+    // Broad prefixes match ~1/8 of the catalog each; narrow ones a handful of rows
+    std::vector<std::string> broad = {"ste", "wire", "lamp", "kitch", "blue"};
+    std::vector<std::string> narrow = {"4242", "9001", "77", "1234", "58"};
+
+    auto bindLike = [](sqlite3_stmt* stmt, const std::string& term) {
+        std::string pattern = "%" + term + "%";
+        sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, pattern.c_str(), -1, SQLITE_TRANSIENT);
+    };
+    auto bindFts = [](sqlite3_stmt* stmt, const std::string& term) {
+        std::string match = "\"" + term + "\"*";
+        sqlite3_bind_text(stmt, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    };
+
+    std::cout << "rows\tterms\tLIKE us/query\tFTS5 us/query\tspeedup\n";
+    for (int rows : sizes) {
+        auto path = (std::filesystem::temp_directory_path() / "search_bench.db").string();
+        for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+
+        if (!Database::init(path, 2) || !Schema::hasFullTextSearch()) {
+            std::cerr << "Benchmark needs SQLite with FTS5" << std::endl;
+            return 1;
+        }
+        seed(rows);
+
+        for (auto* terms : {&broad, &narrow}) {
+            double like = timeQueries(kLikeSql, *terms, bindLike);
+            double fts = timeQueries(kFtsSql, *terms, bindFts);
+            std::cout << rows << "\t" << (terms == &broad ? "broad" : "narrow") << "\t"
+                      << like << "\t\t" << fts << "\t\t" << like / fts << "x\n";
+        }
+
+        Database::release();
+        Database::shutdown();
+        for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+    }
+    return 0;
+}
@@ -1,82 +1,319 @@
 #include "controllers/InventoryController.h"
+#include "controllers/ProductsController.h"
 #include "models/InventoryModel.h"
+#include "utils/JsonWriter.h"
+#include "utils/ConditionalGet.h"
+#include "models/Catalog.h"
+#include "models/LowStockIndex.h"
+#include "models/HotStock.h"
 #include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <climits>
+#include <cmath>
 #include <crow.h>
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
-
-crow::response getInventoryOverview() {
-    try {
-        auto inventory = InventoryModel::fetchInventoryOverview();
-        json jsonData = json::array();
-
-        for (const auto& product : inventory) {
-            jsonData.push_back({
-                {"id", product.id},
-                {"name", product.name},
-                {"barcode", product.barcode},
-                {"quantity", product.stock},
-                {"threshold", product.threshold},
-                {"status", product.status}
-            });
+
+crow::response getInventoryOverview(const crow::request& req) {
+    return conditionalGet(req, [] {
+        try {
+            JsonWriter out;
+            InventoryModel::writeInventoryOverviewJson(out);
+
+            crow::response res(200, out.take());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        } catch (const std::exception& e) {
+            return crow::response(500, std::string("Error retrieving inventory: ") + e.what());
         }
+    });
+}
+
+// The product's catalog JSON after a stock write
+static crow::response stockResponse(const std::string& id, int stock) {
+    Epoch::Guard guard;
+    const CatalogSnapshot* snapshot = Catalog::current();
+    const CatalogEntry* entry = snapshot ? snapshot->find(id) : nullptr;
+    crow::response res(200);
+    if (entry) {
+        res.body = entry->json;
+    } else {
+        JsonWriter out;
+        out.beginObject();
+        out.key("id"); out.value(id);
+        out.key("stock"); out.value(stock);
+        out.endObject();
+        res.body = out.take();
+    }
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+// 202: accepted into a hot product's counters, written by the next flush
+static crow::response hotResponse(const std::string& id, int delta) {
+    JsonWriter out;
+    out.beginObject();
+    out.key("id"); out.value(id);
+    out.key("delta"); out.value(delta);
+    out.key("hot"); out.value(true);
+    out.endObject();
+    crow::response res(202, out.take());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+static crow::response deltaResponse(const std::string& id, MovementKind kind, int delta, const std::string& reference) {
+    // Hot products batch plain receives and picks in memory; the reference is not kept
+    if (kind == MovementKind::RECEIVE || kind == MovementKind::PICK) {
+        HotDeltaResult hot = HotStock::apply(id, delta);
+        if (hot == HotDeltaResult::EXHAUSTED && HotStock::flush(id)) hot = HotStock::apply(id, delta);
+        if (hot == HotDeltaResult::APPLIED) return hotResponse(id, delta);
+        if (hot == HotDeltaResult::INSUFFICIENT) return crow::response(409, "Insufficient stock");
+        // NOT_HOT, or more than the headroom allows at once: write it directly
+    }
+
+    int stock = 0;
+    StockDeltaResult result = StockDeltaResult::FAILED;
+    HotStock::exclusive(id, [&] {
+        result = InventoryModel::applyStockDelta(id, kind, delta, reference, stock);
+        return result == StockDeltaResult::APPLIED;
+    });
+    switch (result) {
+        case StockDeltaResult::APPLIED:
+            return stockResponse(id, stock);
+        case StockDeltaResult::NOT_FOUND:
+            return crow::response(404, "Product not found");
+        case StockDeltaResult::INSUFFICIENT:
+            return crow::response(409, "Insufficient stock");
+        default:
+            return crow::response(500, "Failed to update stock");
+    }
+}
+
+// A whole JSON number within int range; larger values are rejected, not truncated
+static bool parseInt(const crow::json::rvalue& v, int& out) {
+    if (v.t() != crow::json::type::Number) return false;
+    double d = v.d();
+    if (!(d >= INT_MIN && d <= INT_MAX) || d != std::floor(d)) return false;
+    out = static_cast<int>(d);
+    return true;
+}
+
+static crow::response setStockResponse(const std::string& id, int stock) {
+    // FAILED also covers a hot product whose pending deltas could not be flushed
+    StockDeltaResult result = StockDeltaResult::FAILED;
+    HotStock::exclusive(id, [&] {
+        result = InventoryModel::updateStockQuantity(id, stock);
+        return result == StockDeltaResult::APPLIED;
+    });
+    switch (result) {
+        case StockDeltaResult::APPLIED:
+            return stockResponse(id, stock);
+        case StockDeltaResult::NOT_FOUND:
+            return crow::response(404, "Product not found");
+        default:
+            return crow::response(500, "Failed to update stock");
+    }
+}
+
+crow::response updateStock(const crow::request& req, const std::string& id) {
+    auto body = crow::json::load(req.body);
+    if (!body) {
+        return crow::response(400, "Invalid JSON");
+    }
+
+    // {"stock": N} sets the level; {"quantity": N, "operation": ...} is what the inventory page sends
+    if (body.has("stock")) {
+        int stock;
+        if (!parseInt(body["stock"], stock)) return crow::response(400, "Invalid 'stock'");
+        if (stock < 0) return crow::response(400, "Stock cannot be negative");
+        return setStockResponse(id, stock);
+    }
+    if (!body.has("quantity") || !body.has("operation")) {
+        return crow::response(400, "Missing 'quantity' or 'operation' field");
+    }
+
+    int quantity;
+    if (!parseInt(body["quantity"], quantity)) {
+        return crow::response(400, "Invalid 'quantity'");
+    }
+    std::string operation = body["operation"].s();
+    if (quantity < 0) {
+        return crow::response(400, "Quantity cannot be negative");
+    }
+    if (operation == "add") {
+        return deltaResponse(id, MovementKind::RECEIVE, quantity, "");
+    }
+    if (operation == "subtract") {
+        return deltaResponse(id, MovementKind::PICK, -quantity, "");
+    }
+    if (operation == "set") {
+        return setStockResponse(id, quantity);
+    }
+    return crow::response(400, "Invalid operation");
+}
+
+crow::response applyStockDelta(const crow::request& req, const std::string& id) {
+    auto body = crow::json::load(req.body);
+    if (!body || !body.has("delta")) {
+        return crow::response(400, "Missing 'delta' field");
+    }
 
-        return crow::response(200, jsonData.dump());
-    } catch (const std::exception& e) {
-        return crow::response(500, std::string("Error retrieving inventory: ") + e.what());
+    int delta;
+    if (!parseInt(body["delta"], delta)) {
+        return crow::response(400, "Invalid 'delta'");
     }
+    MovementKind kind = delta >= 0 ? MovementKind::RECEIVE : MovementKind::PICK;
+    if (body.has("kind") && !parseMovementKind(body["kind"].s(), kind)) {
+        return crow::response(400, "Invalid kind");
+    }
+    if (delta == 0) {
+        return crow::response(400, "Delta cannot be zero");
+    }
+    if ((kind == MovementKind::RECEIVE && delta < 0) || (kind == MovementKind::PICK && delta > 0)) {
+        return crow::response(400, "Receive needs a positive delta, pick a negative one");
+    }
+    std::string reference = body.has("reference") ? std::string(body["reference"].s()) : std::string();
+
+    return deltaResponse(id, kind, delta, reference);
 }
 
-crow::response updateStock(const crow::request& req, int id) {
+crow::response getStockMovements(const crow::request& req, const std::string& id) {
+    size_t limit = 100;
+    if (auto raw = req.url_params.get("limit")) {
+        char* end = nullptr;
+        long n = std::strtol(raw, &end, 10);
+        if (end == raw || *end != '\0' || n < 1)
+            return crow::response(400, "Invalid limit");
+        limit = static_cast<size_t>(std::min(n, 1000L));
+    }
+
+    JsonWriter out;
+    InventoryModel::writeStockMovementsJson(out, id, limit);
+    crow::response res(200, out.take());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+crow::response promoteHotStock(const crow::request& req, const std::string& id) {
     auto body = crow::json::load(req.body);
-    if (!body || !body.has("stock")) {
-        return crow::response(400, "Missing 'stock' field");
+    if (!body || !body.has("headroom")) {
+        return crow::response(400, "Missing 'headroom' field");
     }
+    int64_t headroom = body["headroom"].i();
+    if (headroom <= 0) {
+        return crow::response(400, "Headroom must be positive");
+    }
+    if (!HotStock::promote(id, headroom)) {
+        return crow::response(404, "Product not found");
+    }
+    return crow::response(200);
+}
 
-    int stock = body["stock"].i();
-    if (InventoryModel::updateStockQuantity(id, stock)) {
+crow::response demoteHotStock(const std::string& id) {
+    if (HotStock::demote(id)) {
         return crow::response(200);
     }
+    return crow::response(404, "Product is not hot");
+}
+
+crow::response getHotStock() {
+    JsonWriter out;
+    out.beginArray();
+    for (const auto& hot : HotStock::stats()) {
+        out.beginObject();
+        out.key("id"); out.value(hot.productId);
+        out.key("headroom"); out.value(hot.headroom);
+        out.key("budget"); out.value(hot.budget);
+        out.key("pending"); out.value(hot.pending);
+        out.key("flushed_stock"); out.value(hot.flushedStock);
+        out.key("flushes"); out.value(hot.flushes);
+        out.endObject();
+    }
+    out.endArray();
 
-    return crow::response(500, "Failed to update stock");
+    crow::response res(200, out.take());
+    res.set_header("Content-Type", "application/json");
+    return res;
 }
 
-crow::response getAlerts() {
-    try {
-        auto alerts = InventoryModel::fetchInventoryAlerts();
-        crow::json::wvalue json;
+crow::response getAlerts(const crow::request& req) {
+    return conditionalGet(req, [] {
+        try {
+            JsonWriter out;
+            out.beginArray();
+            for (const auto& alert : InventoryModel::fetchInventoryAlerts()) {
+                out.beginObject();
+                out.key("id"); out.value(alert.id);
+                out.key("type"); out.value(alert.type);
+                out.key("message"); out.value(alert.message);
+                out.key("product_id"); out.value(alert.productId);
+                out.key("severity"); out.value(alert.severity);
+                out.key("created_at"); out.value(alert.createdAt);
+                out.endObject();
+            }
+            out.endArray();
 
-        for (size_t i = 0; i < alerts.size(); ++i) {
-            json["alerts"][i]["id"] = alerts[i].id;
-            json["alerts"][i]["product_id"] = alerts[i].productId;
-            json["alerts"][i]["message"] = alerts[i].message;
-            json["alerts"][i]["created_at"] = alerts[i].createdAt;
+            crow::response res(200, out.take());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        } catch (const std::exception& e) {
+            return crow::response(500, std::string("Error fetching alerts: ") + e.what());
         }
+    });
+}
 
-        return crow::response{json};
-    } catch (const std::exception& e) {
-        return crow::response(500, std::string("Error fetching alerts: ") + e.what());
+// Writes the catalog JSON of each index hit, most critical first
+static crow::response lowStockResponse(const crow::request& req, double maxRatio) {
+    size_t limit = 50;
+    if (auto raw = req.url_params.get("limit")) {
+        char* end = nullptr;
+        long n = std::strtol(raw, &end, 10);
+        if (end == raw || *end != '\0' || n < 1)
+            return crow::response(400, "Invalid limit");
+        limit = static_cast<size_t>(std::min(n, 1000L));
     }
+
+    return conditionalGet(req, [&] {
+        JsonWriter out;
+        out.beginArray();
+        Epoch::Guard guard;
+        const CatalogSnapshot* snapshot = Catalog::current();
+        for (const auto& item : LowStockIndex::top(limit, maxRatio)) {
+            const CatalogEntry* entry = snapshot ? snapshot->find(item.id) : nullptr;
+            if (entry) out.raw(entry->json);
+        }
+        out.endArray();
+
+        crow::response res(200, out.take());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
 }
 
-crow::response deleteAlert(int id) {
+crow::response getLowStock(const crow::request& req) {
+    // stock <= threshold, out-of-stock items first
+    return lowStockResponse(req, 1.0);
+}
+
+crow::response getOutOfStock(const crow::request& req) {
+    return lowStockResponse(req, 0.0);
+}
+
+crow::response deleteAlert(const std::string& id) {
     if (InventoryModel::deleteInventoryAlert(id)) {
         return crow::response(200);
     }
     return crow::response(500, "Failed to delete alert");
 }
 
-crow::response exportInventory() {
-    if (InventoryModel::exportCSV("inventory_export.csv")) {
-        return crow::response(200);
-    }
-    return crow::response(500, "CSV export failed");
+crow::response exportInventory(const crow::request& req) {
+    // The products export carries stock, threshold and status
+    crow::response res = exportProducts(req);
+    if (res.code == 200 || res.code == 206) res.set_header("Content-Disposition", "attachment; filename=inventory_export.csv");
+    return res;
 }
 
-crow::response importInventory() {
-    if (InventoryModel::importCSV("inventory_export.csv")) {
-        return crow::response(200);
-    }
-    return crow::response(500, "CSV import failed");
+crow::response importInventory(const crow::request& req) {
+    // Same file format as the products import
+    return importProducts(req);
 }
@@ -1,16 +1,30 @@
 #include "controllers/ProductsController.h"
 #include "models/ProductModel.h"
+#include "models/BarcodeIndex.h"
+#include "models/Catalog.h"
+#include "models/ChangeLog.h"
+#include "models/ProductImport.h"
+#include "models/ExportCache.h"
+#include "models/HotStock.h"
+#include "utils/JsonWriter.h"
+#include "utils/ConditionalGet.h"
+#include "utils/ByteRange.h"
 #include <crow.h>
 #include <iostream>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
-#include <csv.h>
 #include <fstream>
 #include <cstdio>
 #include <models/ProductModel.h>
 #include <filesystem>
-std::string statusToString(ProductStatus status);
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+#include <functional>
+#include <unordered_set>
 
 
 static std::string generateUUID() {
@@ -19,10 +33,296 @@ static std::string generateUUID() {
     return boost::uuids::to_string(uuid);
 }
 
-crow::response getAllProducts() {
-    auto products = getAllProductsFromDB();
-    auto json = serializeProductsToJson(products);
-    return crow::response{json};
+// Cursor tokens are the last id of the previous page, base64url-encoded so clients treat them as opaque
+static std::string encodeCursor(const std::string& lastId) {
+    return crow::utility::base64encode_urlsafe(lastId, lastId.size());
+}
+
+static std::string decodeCursor(const std::string& cursor) {
+    return crow::utility::base64decode(cursor, cursor.size());
+}
+
+struct PageParams {
+    bool paged = false;     // caller asked for a page rather than the full list
+    int limit = 100;
+    std::string after;
+};
+
+// Reads ?limit=N&after=<cursor>; returns false on a malformed limit
+static bool parsePageParams(const crow::request& req, PageParams& params) {
+    auto limit = req.url_params.get("limit");
+    auto after = req.url_params.get("after");
+    params.paged = limit || after;
+
+    if (limit) {
+        char* end = nullptr;
+        long n = std::strtol(limit, &end, 10);
+        if (end == limit || *end != '\0' || n < 1) return false;
+        params.limit = static_cast<int>(std::min(n, 1000L));
+    }
+    if (after && *after) {
+        params.after = decodeCursor(after);
+    }
+    return true;
+}
+
+static crow::response jsonResponse(JsonWriter& out) {
+    crow::response res(200, out.take());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+// Wraps one page written by `writeItems` as {"items": [...], "next_cursor": ...}
+template <typename WriteItems>
+static crow::response pageResponse(WriteItems writeItems) {
+    JsonWriter out;
+    out.beginObject();
+    out.key("items");
+    std::optional<std::string> next = writeItems(out);
+    out.key("next_cursor");
+    if (next) out.value(encodeCursor(*next));
+    else out.null();
+    out.endObject();
+    return jsonResponse(out);
+}
+
+crow::response getAllProducts(const crow::request& req) {
+    PageParams params;
+    if (!parsePageParams(req, params))
+        return crow::response(400, "Invalid limit");
+
+    return conditionalGet(req, [&] {
+        // Without limit/after keep returning the plain array the frontend expects
+        if (!params.paged) {
+            std::string stitched;
+            if (Catalog::writeProductListJson(stitched)) {
+                crow::response res(200, std::move(stitched));
+                res.set_header("Content-Type", "application/json");
+                return res;
+            }
+            JsonWriter out;
+            writeAllProductsJson(out);
+            return jsonResponse(out);
+        }
+
+        return pageResponse([&](JsonWriter& out) {
+            return writeProductsPageJson(out, params.after, params.limit);
+        });
+    });
+}
+
+crow::response getCategories(const crow::request& req) {
+    return conditionalGet(req, [] {
+        JsonWriter out;
+        out.beginArray();
+        for (const auto& category : Catalog::loaded() ? Catalog::categories() : getAllCategoriesFromDB()) {
+            out.value(category);
+        }
+        out.endArray();
+        return jsonResponse(out);
+    });
+}
+
+// Optional numeric query parameter; false when present but malformed
+template <typename T>
+static bool parseNumberParam(const crow::request& req, const char* name, std::optional<T>& out) {
+    const char* raw = req.url_params.get(name);
+    if (!raw) return true;
+    char* end = nullptr;
+    if constexpr (std::is_floating_point_v<T>) {
+        double v = std::strtod(raw, &end);
+        if (end == raw || *end != '\0' || !std::isfinite(v)) return false;
+        out = v;
+    } else {
+        long v = std::strtol(raw, &end, 10);
+        if (end == raw || *end != '\0' || v < INT32_MIN || v > INT32_MAX) return false;
+        out = static_cast<T>(v);
+    }
+    return true;
+}
+
+// A stock or threshold from a JSON body: a whole number from 0 to INT32_MAX
+static bool parseCount(const crow::json::rvalue& v, int& out) {
+    if (v.t() != crow::json::type::Number) return false;
+    double d = v.d();
+    if (!(d >= 0 && d <= INT32_MAX) || d != std::floor(d)) return false;
+    out = static_cast<int>(d);
+    return true;
+}
+
+// GET /api/products/filter?min_stock=&max_stock=&min_price=&max_price=&below_threshold=1&category=&status=&limit=
+crow::response filterProducts(const crow::request& req) {
+    ProductFilter filter;
+    if (!parseNumberParam(req, "min_stock", filter.minStock) || !parseNumberParam(req, "max_stock", filter.maxStock))
+        return crow::response(400, "Invalid stock bound");
+    if (!parseNumberParam(req, "min_price", filter.minPrice) || !parseNumberParam(req, "max_price", filter.maxPrice))
+        return crow::response(400, "Invalid price bound");
+
+    if (auto below = req.url_params.get("below_threshold")) {
+        filter.belowThreshold = std::string(below) == "1" || std::string(below) == "true";
+    }
+    if (auto category = req.url_params.get("category")) {
+        filter.category = category;
+    }
+    if (auto status = req.url_params.get("status")) {
+        filter.status = parseStatus(status);
+        if (filter.status == ProductStatus::UNKNOWN)
+            return crow::response(400, "Invalid status");
+    }
+
+    std::optional<int> limit;
+    if (!parseNumberParam(req, "limit", limit) || (limit && *limit < 1))
+        return crow::response(400, "Invalid limit");
+
+    return conditionalGet(req, [&] {
+        JsonWriter out;
+        if (!Catalog::writeFilterJson(filter, static_cast<size_t>(std::min(limit.value_or(100), 1000)), out))
+            return crow::response(503, "Catalog not loaded");
+        return jsonResponse(out);
+    });
+}
+
+// GET /api/products/changes?since=<seq>&limit=N
+// Changes after `since`, oldest first, each with the product's current state (null once deleted).
+// Clients keep `next` as their cursor; 410 means the entries they need were compacted away.
+crow::response getProductChanges(const crow::request& req) {
+    uint64_t since = 0;
+    if (auto raw = req.url_params.get("since")) {
+        char* end = nullptr;
+        since = std::strtoull(raw, &end, 10);
+        if (end == raw || *end != '\0' || *raw == '-')
+            return crow::response(400, "Invalid since");
+    }
+    std::optional<int> limit;
+    if (!parseNumberParam(req, "limit", limit) || (limit && *limit < 1))
+        return crow::response(400, "Invalid limit");
+
+    return conditionalGet(req, [&] {
+        std::vector<ProductChange> changes;
+        uint64_t latest = 0;
+        size_t pageSize = static_cast<size_t>(std::min(limit.value_or(500), 5000));
+        switch (ChangeLog::read(since, pageSize, changes, latest)) {
+            case ChangeReadResult::COMPACTED: {
+                JsonWriter out;
+                out.beginObject();
+                out.key("error"); out.value("Changes since this sequence were compacted; refetch the catalog");
+                out.key("latest"); out.value(latest);
+                out.endObject();
+                crow::response res(410, out.take());
+                res.set_header("Content-Type", "application/json");
+                return res;
+            }
+            case ChangeReadResult::FAILED:
+                return crow::response(500, "Failed to read changes");
+            case ChangeReadResult::OK:
+                break;
+        }
+
+        JsonWriter out;
+        out.beginObject();
+        out.key("changes");
+        out.beginArray();
+        {
+            Epoch::Guard guard;
+            const CatalogSnapshot* snapshot = Catalog::current();
+            for (const auto& change : changes) {
+                out.beginObject();
+                out.key("seq"); out.value(change.seq);
+                out.key("op"); out.value(change.op);
+                out.key("id"); out.value(change.productId);
+                out.key("changed_at"); out.value(change.changedAt);
+                out.key("product");
+                if (snapshot) {
+                    const CatalogEntry* entry = snapshot->find(change.productId);
+                    if (entry) out.raw(entry->json);
+                    else out.null();
+                } else if (auto product = getProductByIdFromDB(change.productId)) {
+                    writeProductJson(out, *product);
+                } else {
+                    out.null();
+                }
+                out.endObject();
+            }
+        }
+        out.endArray();
+        uint64_t next = changes.empty() ? std::max(since, latest) : changes.back().seq;
+        out.key("next"); out.value(next);
+        out.key("latest"); out.value(latest);
+        out.key("has_more"); out.value(next < latest);
+        out.endObject();
+        return jsonResponse(out);
+    });
+}
+
+crow::response searchProductList(const crow::request& req) {
+    auto query = req.url_params.get("q");
+    if (!query) {
+        return crow::response(400, "Missing search query");
+    }
+
+    PageParams params;
+    if (!parsePageParams(req, params))
+        return crow::response(400, "Invalid limit");
+
+    if (!params.paged) {
+        JsonWriter out;
+        writeSearchResultsJson(out, query);
+        return jsonResponse(out);
+    }
+
+    return pageResponse([&](JsonWriter& out) {
+        return writeSearchPageJson(out, query, params.after, params.limit);
+    });
+}
+
+crow::response lookupProducts(const crow::request& req) {
+    auto body = crow::json::load(req.body);
+    if (!body)
+        return crow::response(400, "Invalid JSON");
+
+    // Any of ids / skus / barcodes; each comes back under the same name, in request order
+    const std::pair<const char*, ProductKey> kinds[] = {
+        {"ids", ProductKey::ID}, {"skus", ProductKey::SKU}, {"barcodes", ProductKey::BARCODE}
+    };
+    const size_t maxKeys = 1000;
+
+    struct Requested {
+        const char* name;
+        ProductKey by;
+        std::vector<std::string> keys;
+    };
+    std::vector<Requested> requested;
+    size_t total = 0;
+    for (const auto& [name, by] : kinds) {
+        if (!body.has(name)) continue;
+        const auto& list = body[name];
+        if (list.t() != crow::json::type::List)
+            return crow::response(400, std::string("'") + name + "' must be an array of strings");
+
+        std::vector<std::string> keys;
+        keys.reserve(list.size());
+        for (const auto& key : list) {
+            if (key.t() != crow::json::type::String)
+                return crow::response(400, std::string("'") + name + "' must be an array of strings");
+            keys.push_back(key.s());
+        }
+        total += keys.size();
+        requested.push_back({name, by, std::move(keys)});
+    }
+
+    if (requested.empty())
+        return crow::response(400, "Expected 'ids', 'skus' or 'barcodes'");
+    if (total > maxKeys)
+        return crow::response(400, "At most 1000 keys per lookup");
+
+    JsonWriter out;
+    out.beginObject();
+    for (const auto& r : requested) {
+        out.key(r.name);
+        writeProductLookupJson(out, r.by, r.keys);
+    }
+    out.endObject();
+    return jsonResponse(out);
 }
 
 crow::response addProduct(const crow::request& req) {
@@ -43,10 +343,7 @@ crow::response addProduct(const crow::request& req) {
     int threshold = body["threshold"].i();
     double price = body["price"].d();
 
-    std::string statusStr = body.has("status") ? std::string(body["status"].s()) : std::string("in-stock");
-    ProductStatus status = parseStatus(statusStr);
-
-    bool success = insertProduct(id, name, sku, barcode, category, stock, threshold, price, status);
+    bool success = insertProduct(id, name, sku, barcode, category, stock, threshold, price);
     if (!success)
         return crow::response(500, "Failed to insert product");
 
@@ -56,8 +353,145 @@ crow::response addProduct(const crow::request& req) {
     return crow::response(201, res);
 }
 
+// Validates one bulk row; returns an empty string when the row is usable
+static std::string parseBulkRow(const crow::json::rvalue& row, Product& p) {
+    if (row.t() != crow::json::type::Object)
+        return "Row must be an object";
+
+    const char* strings[] = {"name", "sku", "barcode", "category"};
+    for (const char* field : strings) {
+        if (!row.has(field) || row[field].t() != crow::json::type::String)
+            return std::string("Missing or invalid '") + field + "'";
+    }
+    const char* numbers[] = {"stock", "threshold", "price"};
+    for (const char* field : numbers) {
+        if (!row.has(field) || row[field].t() != crow::json::type::Number)
+            return std::string("Missing or invalid '") + field + "'";
+    }
+    if (row.has("id") && row["id"].t() != crow::json::type::String)
+        return "Invalid 'id'";
+
+    p.id = row.has("id") ? std::string(row["id"].s()) : std::string();
+    p.name = row["name"].s();
+    p.sku = row["sku"].s();
+    p.barcode = row["barcode"].s();
+    p.category = row["category"].s();
+    if (!parseCount(row["stock"], p.stock))
+        return "'stock' must be a whole number from 0 to 2147483647";
+    if (!parseCount(row["threshold"], p.threshold))
+        return "'threshold' must be a whole number from 0 to 2147483647";
+    p.price = row["price"].d();
+
+    if (p.name.empty() || p.sku.empty())
+        return "'name' and 'sku' must not be empty";
+    return {};
+}
+
+// Runs `write` inside HotStock::exclusive for each of `hot` (sorted, so two
+// callers take them in the same order): pending deltas are flushed first and
+// no pick lands until the write is done
+static bool holdingHotStock(const std::vector<std::string>& hot, size_t next, const std::function<bool()>& write) {
+    if (next == hot.size()) return write();
+    return HotStock::exclusive(hot[next], [&] { return holdingHotStock(hot, next + 1, write); });
+}
+
+crow::response bulkUpsertProductList(const crow::request& req) {
+    auto body = crow::json::load(req.body);
+    if (!body)
+        return crow::response(400, "Invalid JSON");
+
+    // Either a bare array or {"products": [...]}
+    const crow::json::rvalue* list = &body;
+    if (body.t() == crow::json::type::Object && body.has("products"))
+        list = &body["products"];
+    if (list->t() != crow::json::type::List)
+        return crow::response(400, "Expected an array of products");
+
+    const size_t maxRows = 100000;
+    if (list->size() > maxRows)
+        return crow::response(400, "At most 100000 products per request");
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Invalid rows are reported without ever reaching the database
+    std::vector<std::string> errors(list->size());
+    std::vector<Product> valid;
+    std::vector<size_t> validIndex;
+    valid.reserve(list->size());
+    validIndex.reserve(list->size());
+    size_t index = 0;
+    for (const auto& row : *list) {
+        Product p;
+        errors[index] = parseBulkRow(row, p);
+        if (errors[index].empty()) {
+            valid.push_back(std::move(p));
+            validIndex.push_back(index);
+        }
+        ++index;
+    }
+
+    // Rows upsert on sku, so a hot product is touched when its sku is in the batch
+    std::unordered_set<std::string_view> skus;
+    for (const auto& p : valid) skus.insert(p.sku);
+    std::vector<std::string> hot;
+    for (const auto& h : HotStock::stats()) {
+        auto product = Catalog::find(h.productId);
+        if (!product || skus.count(product->sku)) hot.push_back(h.productId);
+    }
+    std::sort(hot.begin(), hot.end());
+
+    std::vector<BulkRowResult> written;
+    bool flushed = holdingHotStock(hot, 0, [&] {
+        written = bulkUpsertProducts(valid);
+        return true;
+    });
+    if (!flushed)
+        return crow::response(500, "Failed to flush pending stock");
+
+    size_t inserted = 0, updated = 0, failed = 0;
+    std::vector<const BulkRowResult*> byIndex(errors.size(), nullptr);
+    for (size_t i = 0; i < written.size(); ++i) {
+        byIndex[validIndex[i]] = &written[i];
+    }
+
+    JsonWriter out;
+    out.beginObject();
+    out.key("results");
+    out.beginArray();
+    for (size_t i = 0; i < errors.size(); ++i) {
+        const BulkRowResult* r = byIndex[i];
+        out.beginObject();
+        out.key("index"); out.value(static_cast<uint64_t>(i));
+        if (r && r->ok) {
+            out.key("ok"); out.value(true);
+            out.key("id"); out.value(r->id);
+            out.key("action"); out.value(r->inserted ? "inserted" : "updated");
+            ++(r->inserted ? inserted : updated);
+        } else {
+            out.key("ok"); out.value(false);
+            out.key("error"); out.value(r ? r->error : errors[i]);
+            ++failed;
+        }
+        out.endObject();
+    }
+    out.endArray();
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    out.key("inserted"); out.value(static_cast<uint64_t>(inserted));
+    out.key("updated"); out.value(static_cast<uint64_t>(updated));
+    out.key("failed"); out.value(static_cast<uint64_t>(failed));
+    out.key("elapsed_ms"); out.value(elapsedMs);
+    out.key("rows_per_sec"); out.value(elapsedMs > 0 ? (inserted + updated) * 1000.0 / elapsedMs : 0.0);
+    out.endObject();
+
+    crow::response res = jsonResponse(out);
+    // Partial success is still a 200; the per-row results say which rows failed
+    if (inserted + updated == 0 && failed > 0) res.code = 422;
+    return res;
+}
+
 crow::response getProductById(const crow::request& req, const std::string& id) {
-    auto productOpt = getProductByIdFromDB(id);
+    auto productOpt = Catalog::loaded() ? Catalog::find(id) : getProductByIdFromDB(id);
     if (!productOpt.has_value()) {
         return crow::response(404, "Product not found");
     }
@@ -69,6 +503,18 @@ crow::response scanProductByBarcode(const crow::request& req) {
     if (!barcode) {
         return crow::response(400, "Missing barcode");
     }
+
+    // The index mirrors every committed write, so once loaded a miss is a real 404
+    if (BarcodeIndex::loaded()) {
+        std::string json;
+        if (!BarcodeIndex::lookupJson(barcode, json)) {
+            return crow::response(404, "Product not found");
+        }
+        crow::response res(200, std::move(json));
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+
     auto productOpt = getProductByBarcode(barcode);
     if (!productOpt.has_value()) {
         return crow::response(404, "Product not found");
@@ -101,13 +547,14 @@ crow::response updateProduct(const crow::request& req, const std::string& id) {
     std::string sku = body["sku"].s();
     std::string barcode = body["barcode"].s();
     std::string category = body["category"].s();
-    int stock = static_cast<int>(body["stock"].d());
-    int threshold = static_cast<int>(body["threshold"].d());
+    int stock, threshold;
+    if (!parseCount(body["stock"], stock) || !parseCount(body["threshold"], threshold))
+        return crow::response(400, "'stock' and 'threshold' must be whole numbers from 0 to 2147483647");
     double price = body["price"].d();
 
-    std::string statusStr = body.has("status") ? std::string(body["status"].s()) : "in-stock";
-    ProductStatus status = parseStatus(statusStr);
-    bool success = updateProductInDB(id, name, sku, barcode, category, stock, threshold, price, status);
+    bool success = HotStock::exclusive(id, [&] {
+        return updateProductInDB(id, name, sku, barcode, category, stock, threshold, price);
+    });
     if (!success) {
         return crow::response(500, "Failed to update product");
     }
@@ -115,102 +562,179 @@ crow::response updateProduct(const crow::request& req, const std::string& id) {
     return crow::response(200, "Product updated successfully");
 }
 
+crow::response patchProduct(const crow::request& req, const std::string& id) {
+    auto body = crow::json::load(req.body);
+    if (!body || body.t() != crow::json::type::Object)
+        return crow::response(400, "Invalid JSON");
+
+    ProductPatch patch;
+    const std::pair<const char*, std::optional<std::string>*> strings[] = {
+        {"name", &patch.name}, {"sku", &patch.sku}, {"barcode", &patch.barcode},
+        {"category", &patch.category}, {"description", &patch.description}
+    };
+    for (const auto& [name, target] : strings) {
+        if (!body.has(name)) continue;
+        if (body[name].t() != crow::json::type::String)
+            return crow::response(400, std::string("Invalid '") + name + "'");
+        *target = std::string(body[name].s());
+    }
+
+    const std::pair<const char*, std::optional<int>*> integers[] = {
+        {"stock", &patch.stock}, {"threshold", &patch.threshold}
+    };
+    for (const auto& [name, target] : integers) {
+        if (!body.has(name)) continue;
+        int value;
+        if (!parseCount(body[name], value))
+            return crow::response(400, std::string("Invalid '") + name + "': must be a whole number from 0 to 2147483647");
+        *target = value;
+    }
+
+    if (body.has("price")) {
+        if (body["price"].t() != crow::json::type::Number)
+            return crow::response(400, "Invalid 'price'");
+        patch.price = body["price"].d();
+    }
+    if ((patch.name && patch.name->empty()) || (patch.sku && patch.sku->empty()))
+        return crow::response(400, "'name' and 'sku' must not be empty");
+
+    PatchResult result = PatchResult::FAILED;
+    auto write = [&] {
+        result = patchProductInDB(id, patch);
+        return result != PatchResult::FAILED;
+    };
+    // Only a stock change has to wait out a hot product's deltas
+    if (patch.stock) HotStock::exclusive(id, write);
+    else write();
+
+    switch (result) {
+        case PatchResult::UPDATED:
+            return crow::response(200, "Product updated successfully");
+        case PatchResult::UNCHANGED:
+            return crow::response(200, "Product unchanged");
+        case PatchResult::NOT_FOUND:
+            return crow::response(404, "Product not found");
+        case PatchResult::CONFLICT:
+            return crow::response(409, "SKU or barcode already in use");
+        default:
+            return crow::response(500, "Failed to update product");
+    }
+}
+
 crow::response deleteProduct(const std::string& id) {
-    bool success = deleteProductFromDB(id);
+    // Once the row is gone exclusive() retires the product's hot counters
+    bool success = HotStock::exclusive(id, [&] { return deleteProductFromDB(id); });
     if (!success) {
         return crow::response(500, "Failed to delete product");
     }
     return crow::response(200, "Product and associated records deleted successfully");
 }
 
+// The uploaded CSV without copying it: the "file" part of a multipart/form-data
+// body (what the frontend's FormData sends), otherwise the raw body
+static std::string_view uploadedCsv(const crow::request& req) {
+    std::string_view body = req.body;
+    const std::string& type = req.get_header_value("Content-Type");
+    size_t at = type.find("boundary=");
+    if (type.rfind("multipart/form-data", 0) != 0 || at == std::string::npos) return body;
+
+    std::string boundary = type.substr(at + 9);
+    boundary = "--" + boundary.substr(0, boundary.find(';'));
+    if (boundary.size() > 4 && boundary[2] == '"') boundary = "--" + boundary.substr(3, boundary.size() - 4);
+
+    // --boundary CRLF headers CRLF CRLF content CRLF --boundary ...
+    size_t part = body.find(boundary);
+    while (part != std::string_view::npos) {
+        size_t headers = part + boundary.size();
+        if (body.substr(headers, 2) == "--") break;
+        headers += 2;
+        size_t content = body.find("\r\n\r\n", headers);
+        if (content == std::string_view::npos) break;
+        content += 4;
+        size_t next = body.find("\r\n" + boundary, content);
+        if (next == std::string_view::npos) break;
+        if (body.substr(headers, content - headers).find("name=\"file\"") != std::string_view::npos)
+            return body.substr(content, next - content);
+        part = next + 2;
+    }
+    return {};
+}
+
 crow::response importProducts(const crow::request& req) {
-    if (req.body.empty())
+    std::string_view csv = uploadedCsv(req);
+    if (csv.empty())
         return crow::response(400, "Empty CSV file");
 
-    std::string uploadDir = "uploads";
-    std::string tempFileName = uploadDir + "/imported_products.csv";
+    ImportReport report = importProductsCsv(csv);
+    if (!report.headerError.empty())
+        return crow::response(400, "Invalid CSV header: " + report.headerError);
+
+    JsonWriter out;
+    out.beginObject();
+    out.key("imported"); out.value(static_cast<uint64_t>(report.imported));
+    out.key("failed"); out.value(static_cast<uint64_t>(report.failed));
+    out.key("rows"); out.value(static_cast<uint64_t>(report.rows));
+    out.key("seconds"); out.value(report.seconds);
+    out.key("rows_per_sec"); out.value(report.seconds > 0 ? report.rows / report.seconds : 0.0);
+    out.key("errors");
+    out.beginArray();
+    for (const auto& e : report.errors) out.value(e);
+    out.endArray();
+    out.endObject();
+
+    crow::response res(200, out.take());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
 
-    // Ensure uploads/ directory exists
-    std::filesystem::create_directories(uploadDir);
 
-    // Save the uploaded binary data to a file
-    {
-        std::ofstream tempFile(tempFileName, std::ios::binary);
-        if (!tempFile.is_open())
-            return crow::response(500, "Unable to create upload file");
-        tempFile << req.body;
+// The cached export file: 304 while the client's ETag is current, 206 for a
+// single byte range (to resume a download, at most 4 MiB per response),
+// otherwise the whole file, which Crow streams to the socket from disk
+crow::response exportProducts(const crow::request& req) {
+    ExportArtifact artifact;
+    if (!ExportCache::productsCsv(artifact)) {
+        return crow::response(500, "CSV export failed");
     }
-
-    // CSV parser
-    io::CSVReader<9, io::trim_chars<' ', '\t'>, io::no_quote_escape<','>> csvreader(tempFileName);
-    csvreader.read_header(
-        io::ignore_extra_column,
-        "id", "name", "sku", "barcode", "category", "stock", "threshold", "price", "status"
-    );
-
-    std::string id, name, sku, barcode, category, statusStr;
-    int stock = 0, threshold = 0;
-    double price = 0.0;
-
-    int importCount = 0, failCount = 0;
-    while (csvreader.read_row(id, name, sku, barcode, category, stock, threshold, price, statusStr)) {
-        if (id.empty()) id = generateUUID();
-        if (statusStr.empty()) statusStr = "in-stock";
-        ProductStatus status = parseStatus(statusStr);
-
-        bool ok = insertProduct(id, name, sku, barcode, category, stock, threshold, price, status);
-        if (ok) importCount++;
-        else failCount++;
+    std::string etag = DataVersion::etag(artifact.generation);
+    if (ifNoneMatch(req, etag)) {
+        crow::response res(304);
+        res.set_header("ETag", etag);
+        return res;
     }
 
-    crow::json::wvalue res;
-    res["imported"] = importCount;
-    res["failed"] = failCount;
-    return crow::response(200, res);
-}
-
-
-crow::response exportProducts() {
-    auto products = getAllProductsFromDB();
-
-    std::ostringstream csv;
-    csv << "id,name,sku,barcode,category,stock,threshold,price,status\n";
-
-    for (const auto& p : products) {
-        auto csvEscape = [](const std::string& val) -> std::string {
-            std::string out;
-            out.reserve(val.size() + 4);
-            out += '"';
-            for (char c : val) {
-                if (c == '"') out += "\"\"";
-                else out += c;
-            }
-            out += '"';
-            return out;
-        };
-
-        csv << csvEscape(p.id) << "," << csvEscape(p.name) << "," << csvEscape(p.sku) << ","
-            << csvEscape(p.barcode) << "," << csvEscape(p.category) << ","
-            << p.stock << "," << p.threshold << "," << p.price << ","
-            << csvEscape(statusToString(p.status)) << "\n";
+    // If-Range: only resume from the same file
+    ByteRange range{};
+    RangeMatch match = RangeMatch::NONE;
+    std::string ifRange = req.get_header_value("If-Range");
+    if (ifRange.empty() || ifRange == etag) {
+        match = parseRange(req.get_header_value("Range"), artifact.size, range);
     }
 
-    // Ensure the "exports" directory exists
-    std::string exportDir = "exports";
-    std::filesystem::create_directories(exportDir);
-
-    // Write CSV to local file
-    std::string filePath = exportDir + "/products_export.csv";
-    std::ofstream outFile(filePath);
-    if (!outFile.is_open()) {
-        return crow::response(500, "Failed to open export file for writing");
+    crow::response res;
+    if (match == RangeMatch::UNSATISFIABLE) {
+        res.code = 416;
+        res.set_header("Content-Range", "bytes */" + std::to_string(artifact.size));
+        return res;
+    }
+    if (match == RangeMatch::SATISFIABLE) {
+        // The range body is held in memory, so a large range gets its first
+        // part; Content-Range says where it ends and the client asks for the rest
+        const uint64_t maxRangeBytes = 4 * 1024 * 1024;
+        range.last = std::min(range.last, range.first + maxRangeBytes - 1);
+        if (!ExportCache::read(artifact, range.first, range.last - range.first + 1, res.body)) {
+            return crow::response(500, "Failed to read export file");
+        }
+        res.code = 206;
+        res.set_header("Content-Range", "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) +
+                                        "/" + std::to_string(artifact.size));
+    } else {
+        res.set_static_file_info_unsafe(artifact.path);
     }
-    outFile << csv.str();
-    outFile.close();
-
-    // Optionally stream file back as downloadable response
-    crow::response res(csv.str());
     res.set_header("Content-Type", "text/csv");
     res.set_header("Content-Disposition", "attachment; filename=products_export.csv");
+    res.set_header("Accept-Ranges", "bytes");
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
     return res;
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "db/DataVersion.h"
+#include <atomic>
+#include <chrono>
+
+namespace {
+    std::atomic<uint64_t> generation{1};
+
+    const uint64_t processId = static_cast<uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch().count());
+
+    void appendHex(std::string& out, uint64_t v) {
+        static const char digits[] = "0123456789abcdef";
+        char buf[16];
+        int n = 0;
+        do {
+            buf[n++] = digits[v & 0xf];
+            v >>= 4;
+        } while (v);
+        while (n) out.push_back(buf[--n]);
+    }
+}
+
+namespace DataVersion {
+    uint64_t current() {
+        return generation.load(std::memory_order_acquire);
+    }
+
+    void bump() {
+        generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::string etag(uint64_t gen) {
+        std::string tag = "\"";
+        appendHex(tag, processId);
+        tag.push_back('-');
+        appendHex(tag, gen);
+        tag.push_back('"');
+        return tag;
+    }
+}
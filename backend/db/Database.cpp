@@ -1,19 +1,205 @@
 #include "db/Database.h"
+#include "db/Schema.h"
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
 
-sqlite3* Database::db = nullptr;  // 👈 DEFINE static variable
+struct Database::Connection {
+    struct CachedStatement {
+        sqlite3_stmt* stmt = nullptr;
+        bool inUse = false;
+    };
 
-bool Database::init(const std::string& dbPath) {
-    int rc = sqlite3_open(dbPath.c_str(), &db);
-    if (rc) {
+    sqlite3* db = nullptr;
+    std::unordered_map<std::string, CachedStatement> statements;
+
+    ~Connection() {
+        for (auto& [sql, cached] : statements) {
+            sqlite3_finalize(cached.stmt);
+        }
+        sqlite3_close_v2(db);
+    }
+};
+
+std::string Database::path;
+size_t Database::maxConnections = 0;
+std::vector<Database::Connection*> Database::idle;
+std::vector<std::unique_ptr<Database::Connection>> Database::all;
+std::mutex Database::mutex;
+std::condition_variable Database::available;
+
+namespace {
+    // Returns the leased connection to the pool when the owning thread exits.
+    struct Lease {
+        Database::Connection* conn = nullptr;
+        ~Lease() { if (conn) Database::release(); }
+    };
+
+    thread_local Lease current;
+
+    std::atomic<uint64_t> statementHits{0};
+    std::atomic<uint64_t> statementMisses{0};
+    std::atomic<uint64_t> prepareNanos{0};
+}
+
+Database::Connection* Database::openConnection() {
+    sqlite3* db = nullptr;
+    // NOMUTEX: a connection is only ever used by the thread holding its lease
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(path.c_str(), &db, flags, nullptr) != SQLITE_OK) {
         std::cerr << "[SQLite] Failed to open DB: " << sqlite3_errmsg(db) << std::endl;
-        db = nullptr;
+        sqlite3_close(db);
+        return nullptr;
+    }
+
+    sqlite3_busy_timeout(db, 5000);
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to enable WAL: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+
+    auto* conn = new Connection;
+    conn->db = db;
+    return conn;
+}
+
+bool Database::init(const std::string& dbPath, size_t poolSize) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = dbPath;
+        // One connection per worker thread plus a little headroom for background threads
+        maxConnections = poolSize ? poolSize : std::max(2u, std::thread::hardware_concurrency()) + 2;
+    }
+
+    // Open the first connection eagerly so a bad path fails at startup
+    Connection* conn = openConnection();
+    if (!conn) return false;
+
+    if (!Schema::apply(conn->db)) {
+        delete conn;
         return false;
     }
-    std::cout << "[SQLite] Connected to database: " << dbPath << std::endl;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        all.emplace_back(conn);
+        idle.push_back(conn);
+    }
+    std::cout << "[SQLite] Connected to database: " << dbPath
+              << " (pool of " << maxConnections << ", WAL)" << std::endl;
     return true;
 }
 
+void Database::shutdown() {
+    std::lock_guard<std::mutex> lock(mutex);
+    all.clear();
+    idle.clear();
+    path.clear();
+}
+
+Database::Connection* Database::lease() {
+    if (current.conn) return current.conn;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (path.empty()) return nullptr;
+
+    while (idle.empty() && all.size() >= maxConnections) {
+        available.wait(lock);
+    }
+
+    if (!idle.empty()) {
+        current.conn = idle.back();
+        idle.pop_back();
+        return current.conn;
+    }
+
+    // Reserve the slot before dropping the lock to open the connection
+    all.emplace_back(nullptr);
+    lock.unlock();
+    Connection* conn = openConnection();
+    lock.lock();
+
+    auto slot = std::find(all.begin(), all.end(), nullptr);
+    if (!conn) {
+        all.erase(slot);
+        available.notify_one();
+        return nullptr;
+    }
+    slot->reset(conn);
+    current.conn = conn;
+    return conn;
+}
+
 sqlite3* Database::get() {
-    return db;
+    Connection* conn = lease();
+    return conn ? conn->db : nullptr;
+}
+
+void Database::release() {
+    Connection* conn = current.conn;
+    if (!conn) return;
+
+    // Leave the connection clean for the next lessee
+    if (!sqlite3_get_autocommit(conn->db)) {
+        sqlite3_exec(conn->db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(conn);
+    }
+    current.conn = nullptr;
+    available.notify_one();
+}
+
+Statement Database::prepare(const std::string& sql) {
+    Connection* conn = lease();
+    if (!conn) return {};
+
+    auto& cached = conn->statements[sql];
+    if (cached.stmt && !cached.inUse) {
+        statementHits.fetch_add(1, std::memory_order_relaxed);
+        cached.inUse = true;
+        return Statement(cached.stmt, &cached.inUse);
+    }
+
+    statementMisses.fetch_add(1, std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(conn->db, sql.c_str(), static_cast<int>(sql.size()),
+                                SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    prepareNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+
+    if (rc != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        if (!cached.stmt) conn->statements.erase(sql);
+        return {};
+    }
+
+    // Same SQL already checked out further up the stack: hand out a one-off
+    if (cached.stmt) {
+        return Statement(stmt, nullptr);
+    }
+
+    cached.stmt = stmt;
+    cached.inUse = true;
+    return Statement(stmt, &cached.inUse);
+}
+
+StatementCacheStats Database::statementStats() {
+    return {
+        statementHits.load(std::memory_order_relaxed),
+        statementMisses.load(std::memory_order_relaxed),
+        prepareNanos.load(std::memory_order_relaxed)
+    };
+}
+
+size_t Database::openConnections() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return all.size();
 }
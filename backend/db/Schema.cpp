@@ -0,0 +1,314 @@
+#include "db/Schema.h"
+#include <atomic>
+#include <iostream>
+
+namespace {
+    std::atomic<bool> fullTextSearch{false};
+
+    bool exec(sqlite3* db, const char* sql) {
+        char* errMsg = nullptr;
+        if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::cerr << "[Schema] " << (errMsg ? errMsg : "unknown error") << std::endl;
+            sqlite3_free(errMsg);
+            return false;
+        }
+        return true;
+    }
+
+    bool tableExists(sqlite3* db, const char* name) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT 1 FROM sqlite_master WHERE name = ?", -1, &stmt, nullptr) != SQLITE_OK)
+            return false;
+        sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC);
+        bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+        return exists;
+    }
+
+    // Same tables as schema.sql, for databases created from scratch
+    const char* baseSchema = R"SQL(
+        CREATE TABLE IF NOT EXISTS products (
+            id TEXT PRIMARY KEY,
+            name TEXT NOT NULL,
+            sku TEXT UNIQUE NOT NULL,
+            barcode TEXT UNIQUE,
+            category TEXT,
+            price REAL,
+            stock INTEGER DEFAULT 0,
+            threshold INTEGER DEFAULT 0,
+            description TEXT,
+            status TEXT CHECK(status IN ('in-stock', 'low-stock', 'out-of-stock')),
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+
+        CREATE TABLE IF NOT EXISTS inventory_settings (
+            product_id TEXT,
+            min_stock INTEGER DEFAULT 0,
+            max_stock INTEGER DEFAULT 1000,
+            FOREIGN KEY (product_id) REFERENCES products(id)
+        );
+
+        CREATE TABLE IF NOT EXISTS alerts (
+            id TEXT PRIMARY KEY,
+            type TEXT CHECK(type IN ('low-stock', 'out-of-stock', 'overstock')),
+            message TEXT,
+            product_id TEXT,
+            severity TEXT CHECK(severity IN ('high', 'medium', 'low')),
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            FOREIGN KEY (product_id) REFERENCES products(id)
+        );
+    )SQL";
+
+    // Alert engine. Levels are 0 in stock, 1 low (stock <= threshold), 2 out (stock <= 0);
+    // an alert is raised only when a write moves a product into a different non-zero
+    // level, replacing the one for the level it left; recovery clears it. Overstock uses
+    // inventory_settings.max_stock. Triggers run inside the writing statement, so
+    // alerts commit (or roll back) with the write that caused them.
+    const char* alertSchema = R"SQL(
+        CREATE TRIGGER IF NOT EXISTS alerts_stock_ai AFTER INSERT ON products
+        WHEN new.stock <= new.threshold OR new.stock <= 0 BEGIN
+            INSERT INTO alerts (id, type, message, product_id, severity)
+            VALUES (lower(hex(randomblob(16))),
+                    CASE WHEN new.stock <= 0 THEN 'out-of-stock' ELSE 'low-stock' END,
+                    CASE WHEN new.stock <= 0 THEN new.name || ' is out of stock'
+                         ELSE new.name || ' is low on stock (' || new.stock || ' left, threshold ' || new.threshold || ')' END,
+                    new.id,
+                    CASE WHEN new.stock <= 0 THEN 'high' ELSE 'medium' END);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS alerts_stock_au AFTER UPDATE OF stock, threshold ON products
+        WHEN (CASE WHEN new.stock <= 0 THEN 2 WHEN new.stock <= new.threshold THEN 1 ELSE 0 END)
+          != (CASE WHEN old.stock <= 0 THEN 2 WHEN old.stock <= old.threshold THEN 1 ELSE 0 END) BEGIN
+            DELETE FROM alerts
+            WHERE product_id = new.id
+              AND (type = 'out-of-stock' AND new.stock > 0
+                   OR type = 'low-stock' AND (new.stock > new.threshold OR new.stock <= 0));
+            INSERT INTO alerts (id, type, message, product_id, severity)
+            SELECT lower(hex(randomblob(16))),
+                   CASE WHEN new.stock <= 0 THEN 'out-of-stock' ELSE 'low-stock' END,
+                   CASE WHEN new.stock <= 0 THEN new.name || ' is out of stock'
+                        ELSE new.name || ' is low on stock (' || new.stock || ' left, threshold ' || new.threshold || ')' END,
+                   new.id,
+                   CASE WHEN new.stock <= 0 THEN 'high' ELSE 'medium' END
+            WHERE new.stock <= new.threshold OR new.stock <= 0;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS alerts_overstock_ai AFTER INSERT ON products
+        WHEN new.stock > (SELECT max_stock FROM inventory_settings WHERE product_id = new.id) BEGIN
+            INSERT INTO alerts (id, type, message, product_id, severity)
+            SELECT lower(hex(randomblob(16))), 'overstock',
+                   new.name || ' is overstocked (' || new.stock || ', max ' || max_stock || ')',
+                   new.id, 'low'
+            FROM inventory_settings WHERE product_id = new.id;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS alerts_overstock_au AFTER UPDATE OF stock ON products
+        WHEN (new.stock > (SELECT max_stock FROM inventory_settings WHERE product_id = new.id))
+          IS NOT (old.stock > (SELECT max_stock FROM inventory_settings WHERE product_id = new.id)) BEGIN
+            DELETE FROM alerts WHERE product_id = new.id AND type = 'overstock';
+            INSERT INTO alerts (id, type, message, product_id, severity)
+            SELECT lower(hex(randomblob(16))), 'overstock',
+                   new.name || ' is overstocked (' || new.stock || ', max ' || max_stock || ')',
+                   new.id, 'low'
+            FROM inventory_settings WHERE product_id = new.id AND new.stock > max_stock;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS alerts_product_ad AFTER DELETE ON products BEGIN
+            DELETE FROM alerts WHERE product_id = old.id;
+        END;
+
+        CREATE INDEX IF NOT EXISTS idx_alerts_product ON alerts(product_id);
+        CREATE INDEX IF NOT EXISTS idx_inventory_settings_product ON inventory_settings(product_id);
+    )SQL";
+
+    // Append-only log of product writes for delta sync (GET /api/products/changes).
+    // seq is the rowid, so new entries get max(seq) + 1; compaction always keeps the
+    // newest entry, which keeps seq increasing without AUTOINCREMENT's extra write
+    // per insert. The triggers put each entry in the transaction of its write.
+    const char* changeLogSchema = R"SQL(
+        CREATE TABLE IF NOT EXISTS product_changes (
+            seq INTEGER PRIMARY KEY,
+            op TEXT NOT NULL CHECK(op IN ('insert', 'update', 'delete')),
+            product_id TEXT NOT NULL,
+            changed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+
+        CREATE TRIGGER IF NOT EXISTS product_changes_ai AFTER INSERT ON products BEGIN
+            INSERT INTO product_changes (op, product_id) VALUES ('insert', new.id);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS product_changes_au AFTER UPDATE ON products
+        WHEN old.name IS NOT new.name OR old.sku IS NOT new.sku OR old.barcode IS NOT new.barcode
+          OR old.category IS NOT new.category OR old.description IS NOT new.description
+          OR old.price IS NOT new.price OR old.stock IS NOT new.stock
+          OR old.threshold IS NOT new.threshold OR old.status IS NOT new.status BEGIN
+            INSERT INTO product_changes (op, product_id) VALUES ('update', new.id);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS product_changes_ad AFTER DELETE ON products BEGIN
+            INSERT INTO product_changes (op, product_id) VALUES ('delete', old.id);
+        END;
+    )SQL";
+
+    // Stock movement ledger. Every change to products.stock is recorded by trigger, so
+    // the ledger always sums to the stored stock whichever path wrote it. Writes that
+    // know why stock moved (the delta endpoint) put kind/reference into
+    // stock_movement_context for the duration of their statement; anything else is
+    // recorded as an adjust. A context row with record = 0 suppresses the entry, which
+    // the ledger replay uses when it corrects stock to match the ledger itself.
+    const char* ledgerSchema = R"SQL(
+        CREATE TABLE IF NOT EXISTS stock_movements (
+            id INTEGER PRIMARY KEY,
+            product_id TEXT NOT NULL,
+            kind TEXT NOT NULL CHECK(kind IN ('receive', 'pick', 'adjust', 'transfer')),
+            delta INTEGER NOT NULL,
+            reference TEXT,
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        CREATE INDEX IF NOT EXISTS idx_stock_movements_product ON stock_movements(product_id, id);
+
+        CREATE TABLE IF NOT EXISTS stock_movement_context (
+            kind TEXT,
+            reference TEXT,
+            record INTEGER NOT NULL DEFAULT 1
+        );
+
+        -- Stock of every product as of movement `through_movement`; replay starts from the newest
+        CREATE TABLE IF NOT EXISTS stock_snapshots (
+            id INTEGER PRIMARY KEY,
+            through_movement INTEGER NOT NULL,
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+        CREATE TABLE IF NOT EXISTS stock_snapshot_items (
+            snapshot_id INTEGER NOT NULL,
+            product_id TEXT NOT NULL,
+            stock INTEGER NOT NULL,
+            PRIMARY KEY (snapshot_id, product_id)
+        ) WITHOUT ROWID;
+
+        CREATE TRIGGER IF NOT EXISTS stock_movements_ai AFTER INSERT ON products
+        WHEN coalesce(new.stock, 0) != 0 AND coalesce((SELECT record FROM stock_movement_context), 1) BEGIN
+            INSERT INTO stock_movements (product_id, kind, delta, reference)
+            VALUES (new.id, coalesce((SELECT kind FROM stock_movement_context), 'receive'), new.stock,
+                    (SELECT reference FROM stock_movement_context));
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS stock_movements_au AFTER UPDATE OF stock ON products
+        WHEN coalesce(new.stock, 0) != coalesce(old.stock, 0)
+         AND coalesce((SELECT record FROM stock_movement_context), 1) BEGIN
+            INSERT INTO stock_movements (product_id, kind, delta, reference)
+            VALUES (new.id, coalesce((SELECT kind FROM stock_movement_context), 'adjust'),
+                    coalesce(new.stock, 0) - coalesce(old.stock, 0), (SELECT reference FROM stock_movement_context));
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS stock_movements_ad AFTER DELETE ON products
+        WHEN coalesce(old.stock, 0) != 0 AND coalesce((SELECT record FROM stock_movement_context), 1) BEGIN
+            INSERT INTO stock_movements (product_id, kind, delta, reference)
+            VALUES (old.id, 'adjust', -old.stock, 'deleted');
+        END;
+    )SQL";
+
+    // Products whose stock deltas are batched in memory (models/HotStock.h). A row
+    // outlives a crash, so the product is hot again after restart; flushed_at is
+    // the point its stock is known to be durable up to.
+    const char* hotStockSchema = R"SQL(
+        CREATE TABLE IF NOT EXISTS hot_stock (
+            product_id TEXT PRIMARY KEY,
+            headroom INTEGER NOT NULL CHECK(headroom > 0),
+            flushed_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        );
+    )SQL";
+
+    // Seeds the ledger for products stocked before it existed, so replay matches from day one
+    const char* ledgerSeed = R"SQL(
+        INSERT INTO stock_movements (product_id, kind, delta, reference)
+        SELECT id, 'adjust', stock, 'opening balance' FROM products
+        WHERE coalesce(stock, 0) != 0
+          AND NOT EXISTS (SELECT 1 FROM stock_movements m WHERE m.product_id = products.id);
+    )SQL";
+
+    // Rows written before status was derived server-side
+    const char* statusRepair = R"SQL(
+        UPDATE products
+        SET status = CASE WHEN stock <= 0 THEN 'out-of-stock' WHEN stock <= threshold THEN 'low-stock' ELSE 'in-stock' END
+        WHERE status IS NOT CASE WHEN stock <= 0 THEN 'out-of-stock' WHEN stock <= threshold THEN 'low-stock' ELSE 'in-stock' END;
+    )SQL";
+
+    // Full-text index over the searchable product columns. It is an external
+    // content table keyed on products.rowid, so the text is not stored twice;
+    // run INSERT INTO products_fts(products_fts) VALUES('rebuild') after a VACUUM.
+    const char* fullTextTable = R"SQL(
+        CREATE VIRTUAL TABLE products_fts USING fts5(
+            name, sku, barcode, category, description,
+            content='products', content_rowid='rowid',
+            tokenize='unicode61 remove_diacritics 2'
+        );
+    )SQL";
+
+    // Sync triggers, rank and a full rebuild; also repairs an index created
+    // without them (e.g. by an older schema.sql)
+    const char* fullTextSync = R"SQL(
+        CREATE TRIGGER IF NOT EXISTS products_fts_ai AFTER INSERT ON products BEGIN
+            INSERT INTO products_fts(rowid, name, sku, barcode, category, description)
+            VALUES (new.rowid, new.name, new.sku, new.barcode, new.category, new.description);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS products_fts_ad AFTER DELETE ON products BEGIN
+            INSERT INTO products_fts(products_fts, rowid, name, sku, barcode, category, description)
+            VALUES ('delete', old.rowid, old.name, old.sku, old.barcode, old.category, old.description);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS products_fts_au AFTER UPDATE OF name, sku, barcode, category, description ON products BEGIN
+            INSERT INTO products_fts(products_fts, rowid, name, sku, barcode, category, description)
+            VALUES ('delete', old.rowid, old.name, old.sku, old.barcode, old.category, old.description);
+            INSERT INTO products_fts(rowid, name, sku, barcode, category, description)
+            VALUES (new.rowid, new.name, new.sku, new.barcode, new.category, new.description);
+        END;
+
+        -- Rank matches in the name above sku/barcode, then category, then description
+        INSERT INTO products_fts(products_fts, rank) VALUES ('rank', 'bm25(10.0, 5.0, 5.0, 2.0, 1.0)');
+        INSERT INTO products_fts(products_fts) VALUES ('rebuild');
+    )SQL";
+}
+
+namespace Schema {
+    bool apply(sqlite3* db) {
+        if (!exec(db, baseSchema) || !exec(db, alertSchema) || !exec(db, changeLogSchema) || !exec(db, ledgerSchema) ||
+            !exec(db, hotStockSchema))
+            return false;
+        // A context row only lives inside one write; one left by a crash would mislabel the next
+        exec(db, "DELETE FROM stock_movement_context;");
+        if (exec(db, ledgerSeed) && sqlite3_changes(db) > 0)
+            std::cout << "[Schema] Opened the stock ledger for " << sqlite3_changes(db) << " products" << std::endl;
+        if (exec(db, statusRepair) && sqlite3_changes(db) > 0)
+            std::cout << "[Schema] Re-derived status for " << sqlite3_changes(db) << " products" << std::endl;
+
+        if (!tableExists(db, "products_fts")) {
+            if (!exec(db, "BEGIN;")) return false;
+            if (exec(db, fullTextTable) && exec(db, fullTextSync) && exec(db, "COMMIT;")) {
+                std::cout << "[Schema] Built products_fts full-text index" << std::endl;
+            } else {
+                // SQLite without FTS5: search falls back to LIKE
+                exec(db, "ROLLBACK;");
+                std::cerr << "[Schema] FTS5 unavailable, product search will use LIKE" << std::endl;
+            }
+        } else if (!tableExists(db, "products_fts_ai") || !tableExists(db, "products_fts_ad") ||
+                   !tableExists(db, "products_fts_au")) {
+            if (!exec(db, "BEGIN;")) return false;
+            if (exec(db, fullTextSync) && exec(db, "COMMIT;")) {
+                std::cout << "[Schema] Restored products_fts triggers and rebuilt the index" << std::endl;
+            } else {
+                exec(db, "ROLLBACK;");
+                std::cerr << "[Schema] Could not restore products_fts triggers, product search will use LIKE" << std::endl;
+                exec(db, "DROP TABLE IF EXISTS products_fts;");
+            }
+        }
+        fullTextSearch = tableExists(db, "products_fts");
+        return true;
+    }
+
+    bool hasFullTextSearch() {
+        return fullTextSearch;
+    }
+}
@@ -0,0 +1,179 @@
+#include "db/WriteQueue.h"
+#include "db/Database.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct PendingWrite {
+        std::function<bool()> op;
+        std::promise<bool> result;
+    };
+
+    WriteQueueOptions options;
+    std::deque<PendingWrite> queue;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writer;
+    bool running = false;
+
+    std::atomic<uint64_t> operationCount{0};
+    std::atomic<uint64_t> commitCount{0};
+    std::atomic<uint64_t> failedCommitCount{0};
+
+    thread_local bool onWriterThread = false;
+
+    bool exec(sqlite3* db, const char* sql) {
+        char* errMsg = nullptr;
+        if (sqlite3_exec(db, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::cerr << "[WriteQueue] " << sql << " failed: " << (errMsg ? errMsg : "unknown error") << "\n";
+            sqlite3_free(errMsg);
+            return false;
+        }
+        return true;
+    }
+
+    bool runGuarded(const std::function<bool()>& op) {
+        try {
+            return op();
+        } catch (const std::exception& e) {
+            std::cerr << "[WriteQueue] Write failed: " << e.what() << "\n";
+            return false;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // Runs the op inside a savepoint so a failure only undoes its own changes
+    bool runInSavepoint(sqlite3* db, const std::function<bool()>& op) {
+        if (!exec(db, "SAVEPOINT write_op;")) return false;
+        if (runGuarded(op)) {
+            return exec(db, "RELEASE write_op;");
+        }
+        exec(db, "ROLLBACK TO write_op;");
+        exec(db, "RELEASE write_op;");
+        return false;
+    }
+
+    void commitBatch(sqlite3* db, std::vector<PendingWrite>& batch) {
+        std::vector<bool> results(batch.size(), false);
+
+        bool committed = false;
+        if (db && exec(db, "BEGIN IMMEDIATE;")) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                results[i] = runInSavepoint(db, batch[i].op);
+            }
+            committed = exec(db, "COMMIT;");
+            if (!committed) exec(db, "ROLLBACK;");
+        }
+
+        operationCount.fetch_add(batch.size(), std::memory_order_relaxed);
+        if (committed) commitCount.fetch_add(1, std::memory_order_relaxed);
+        else failedCommitCount.fetch_add(1, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch[i].result.set_value(committed && results[i]);
+        }
+    }
+
+    void writerLoop() {
+        onWriterThread = true;
+        sqlite3* db = Database::get();
+
+        std::vector<PendingWrite> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [] { return !queue.empty() || !running; });
+            if (queue.empty() && !running) break;
+
+            // Commit window: give concurrent writers a moment to join the batch
+            auto deadline = std::chrono::steady_clock::now() + options.maxWait;
+            wake.wait_until(lock, deadline, [] { return queue.size() >= options.maxBatch || !running; });
+
+            while (!queue.empty() && batch.size() < options.maxBatch) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+
+            lock.unlock();
+            commitBatch(db, batch);
+            batch.clear();
+            lock.lock();
+        }
+
+        lock.unlock();
+        Database::release();
+    }
+}
+
+namespace WriteQueue {
+    void start(const WriteQueueOptions& opts) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        options = opts;
+        if (options.maxBatch == 0) options.maxBatch = 1;
+        running = true;
+        writer = std::thread(writerLoop);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        writer.join();
+    }
+
+    bool run(const std::function<bool()>& op) {
+        // Nested call from an op already running on the writer thread
+        if (onWriterThread) {
+            return runGuarded(op);
+        }
+
+        std::future<bool> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (running) {
+                queue.push_back(PendingWrite{op, {}});
+                result = queue.back().result.get_future();
+            }
+        }
+
+        if (result.valid()) {
+            wake.notify_all();
+            return result.get();
+        }
+
+        // No writer thread: run it as its own transaction on the caller's connection
+        sqlite3* db = Database::get();
+        if (!db) return false;
+        if (!sqlite3_get_autocommit(db)) {
+            return runInSavepoint(db, op);
+        }
+        if (!exec(db, "BEGIN IMMEDIATE;")) return false;
+        if (!runGuarded(op)) {
+            exec(db, "ROLLBACK;");
+            return false;
+        }
+        if (!exec(db, "COMMIT;")) {
+            exec(db, "ROLLBACK;");
+            return false;
+        }
+        return true;
+    }
+
+    WriteQueueStats stats() {
+        return {
+            operationCount.load(std::memory_order_relaxed),
+            commitCount.load(std::memory_order_relaxed),
+            failedCommitCount.load(std::memory_order_relaxed)
+        };
+    }
+}
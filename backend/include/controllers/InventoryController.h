@@ -3,21 +3,42 @@
 
 #include <crow.h>
 
-crow::response getInventoryOverview();
+crow::response getInventoryOverview(const crow::request& req);
 
 // Handles PATCH /api/inventory/stock/{id}
-crow::response updateStock(const crow::request& req, int id);
+crow::response updateStock(const crow::request& req, const std::string& id);
+
+// Handles POST /api/inventory/stock/{id}/delta
+crow::response applyStockDelta(const crow::request& req, const std::string& id);
+
+// Handles GET /api/inventory/stock/{id}/movements?limit=K (newest first)
+crow::response getStockMovements(const crow::request& req, const std::string& id);
+
+// Handles PUT /api/inventory/stock/{id}/hot with {"headroom": N}
+crow::response promoteHotStock(const crow::request& req, const std::string& id);
+
+// Handles DELETE /api/inventory/stock/{id}/hot
+crow::response demoteHotStock(const std::string& id);
+
+// Handles GET /api/inventory/hot
+crow::response getHotStock();
 
 // Handles GET /api/inventory/alerts
-crow::response getAlerts();
+crow::response getAlerts(const crow::request& req);
+
+// Handles GET /api/inventory/low-stock?limit=K (most critical first)
+crow::response getLowStock(const crow::request& req);
+
+// Handles GET /api/inventory/out-of-stock?limit=K
+crow::response getOutOfStock(const crow::request& req);
 
 // Handles DELETE /api/inventory/alerts/{id}
-crow::response deleteAlert(int id);
+crow::response deleteAlert(const std::string& id);
 
 // Handles POST /api/inventory/export
-crow::response exportInventory();
+crow::response exportInventory(const crow::request& req);
 
 // Handles POST /api/inventory/import
-crow::response importInventory();
+crow::response importInventory(const crow::request& req);
 
 #endif // INVENTORY_CONTROLLER_H
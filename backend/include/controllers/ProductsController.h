@@ -1,11 +1,18 @@
 #pragma once
 #include "crow.h"
 
-crow::response getAllProducts();
+crow::response getAllProducts(const crow::request& req);
+crow::response getCategories(const crow::request& req);
+crow::response filterProducts(const crow::request& req);
+crow::response getProductChanges(const crow::request& req);
+crow::response searchProductList(const crow::request& req);
 crow::response addProduct(const crow::request& req);
 crow::response getProductById(const crow::request& req, const std::string& id);
 crow::response scanProductByBarcode(const crow::request& req);
+crow::response lookupProducts(const crow::request& req);
+crow::response bulkUpsertProductList(const crow::request& req);
 crow::response updateProduct(const crow::request& req, const std::string& id);
+crow::response patchProduct(const crow::request& req, const std::string& id);
 crow::response deleteProduct(const std::string& id);
 crow::response importProducts(const crow::request& req);
-crow::response exportProducts();
+crow::response exportProducts(const crow::request& req);
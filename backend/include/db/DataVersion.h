@@ -0,0 +1,20 @@
+#ifndef DATA_VERSION_H
+#define DATA_VERSION_H
+
+#include <cstdint>
+#include <string>
+
+// Generation counter for the data served by the read endpoints. Every write
+// path bumps it after its transaction commits, so an unchanged generation
+// means an unchanged catalog and a conditional GET can answer 304 without a
+// query.
+namespace DataVersion {
+    uint64_t current();
+    void bump();
+
+    // Quoted entity tag for a generation; includes a per-process id so tags
+    // handed out before a restart never match afterwards
+    std::string etag(uint64_t generation);
+}
+
+#endif
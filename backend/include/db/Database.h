@@ -3,14 +3,52 @@
 
 #include <sqlite3.h>
 #include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include "db/Statement.h"
 
+struct StatementCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t prepareNanos;  // total time spent in sqlite3_prepare_v3 on cache misses
+};
+
+// Pool of SQLite connections opened in WAL mode. Each thread leases one
+// connection on its first Database::get() and keeps it until release() is
+// called (end of request, see DbLeaseHandler) or the thread exits.
 class Database {
 public:
-    static bool init(const std::string& dbPath);
+    struct Connection;
+
+    static bool init(const std::string& dbPath, size_t maxConnections = 0);
+    static void shutdown();
+
+    // Connection leased to the calling thread; opens or waits for one as needed.
     static sqlite3* get();
+    // Hands the calling thread's connection back to the pool.
+    static void release();
+
+    // Compiled statement for `sql` from the leased connection's cache. The
+    // handle resets itself when it goes out of scope.
+    static Statement prepare(const std::string& sql);
+    static StatementCacheStats statementStats();
+
+    static size_t openConnections();
 
 private:
-    static sqlite3* db;
+    static Connection* lease();
+    static Connection* openConnection();
+
+    static std::string path;
+    static size_t maxConnections;
+    static std::vector<Connection*> idle;
+    static std::vector<std::unique_ptr<Connection>> all;
+    static std::mutex mutex;
+    static std::condition_variable available;
 };
 
 #endif
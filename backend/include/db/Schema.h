@@ -0,0 +1,15 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include <sqlite3.h>
+
+// Idempotent schema upgrades applied at startup on top of schema.sql, so an
+// existing data/inventory.db picks up new indexes, tables and triggers.
+namespace Schema {
+    bool apply(sqlite3* db);
+
+    // products_fts exists and is kept in sync (needs SQLite built with FTS5)
+    bool hasFullTextSearch();
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <sqlite3.h>
+#include <utility>
+
+// Move-only handle to a prepared statement handed out by Database::prepare().
+// Cached statements are reset and unbound on destruction so the next caller
+// gets a clean one; one-off statements (cache slot busy) are finalized.
+class Statement {
+public:
+    Statement() = default;
+    Statement(sqlite3_stmt* stmt, bool* inUse) : stmt(stmt), inUse(inUse) {}
+
+    Statement(Statement&& other) noexcept
+        : stmt(std::exchange(other.stmt, nullptr)), inUse(std::exchange(other.inUse, nullptr)) {}
+
+    Statement& operator=(Statement&& other) noexcept {
+        if (this != &other) {
+            done();
+            stmt = std::exchange(other.stmt, nullptr);
+            inUse = std::exchange(other.inUse, nullptr);
+        }
+        return *this;
+    }
+
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    ~Statement() { done(); }
+
+    sqlite3_stmt* get() const { return stmt; }
+    operator sqlite3_stmt*() const { return stmt; }
+    explicit operator bool() const { return stmt != nullptr; }
+
+private:
+    void done() {
+        if (!stmt) return;
+        if (inUse) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            *inUse = false;
+        } else {
+            sqlite3_finalize(stmt);
+        }
+        stmt = nullptr;
+        inUse = nullptr;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    bool* inUse = nullptr;
+};
+
+#endif
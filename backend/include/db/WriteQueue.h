@@ -0,0 +1,35 @@
+#ifndef WRITE_QUEUE_H
+#define WRITE_QUEUE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+struct WriteQueueOptions {
+    size_t maxBatch = 256;                            // operations per commit
+    std::chrono::microseconds maxWait{1000};          // how long the first queued op may wait for company
+};
+
+struct WriteQueueStats {
+    uint64_t operations;
+    uint64_t commits;
+    uint64_t failedCommits;
+};
+
+// Group commit for mutations. Operations are handed to a single writer thread
+// which runs each one inside its own SAVEPOINT and commits the whole batch in
+// one transaction, so a burst of writes shares a single fsync. The caller
+// still blocks until its batch commits and gets its own result back.
+namespace WriteQueue {
+    void start(const WriteQueueOptions& options = {});
+    void stop();
+
+    // Runs `op` against Database::get() on the writer thread. When the queue is
+    // not running (tools, benchmarks) the op runs inline in its own transaction.
+    bool run(const std::function<bool()>& op);
+
+    WriteQueueStats stats();
+}
+
+#endif
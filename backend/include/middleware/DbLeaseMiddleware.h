@@ -0,0 +1,15 @@
+#pragma once
+#include "crow.h"
+#include "db/Database.h"
+
+// Returns the worker's pooled SQLite connection once the response is built,
+// so a connection is only held for the duration of a request.
+struct DbLeaseHandler {
+    struct context {};
+
+    void before_handle(crow::request&, crow::response&, context&) {}
+
+    void after_handle(const crow::request&, crow::response&, context&) {
+        Database::release();
+    }
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "models/Product.h"
+
+// In-memory barcode -> product index behind /api/products/scan.
+//
+// Entries are immutable snapshots holding the product and its pre-encoded
+// JSON. Lookups take no locks: they walk a hash table of atomic chain heads
+// inside an Epoch::Guard. Writers are serialized, swap in new chains and
+// retire the old nodes through Epoch.
+namespace BarcodeIndex {
+    // Replaces the whole index with `products` and marks it loaded
+    void rebuild(const std::vector<Product>& products);
+
+    // Re-reads one product after a committed write. `load` runs under the
+    // writer lock, so refreshes racing for the same id settle on the newest row;
+    // std::nullopt removes the product.
+    void refresh(const std::string& id, const std::function<std::optional<Product>()>& load);
+
+    void upsert(const Product& product);
+    void remove(const std::string& id);
+
+    // Until the first rebuild() a miss says nothing about the database
+    bool loaded();
+    size_t size();
+
+    // Copies the product's JSON into `json`; false if the barcode is unknown
+    bool lookupJson(std::string_view barcode, std::string& json);
+    std::optional<Product> lookup(std::string_view barcode);
+}
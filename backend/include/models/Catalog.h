@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "models/Product.h"
+#include "utils/Epoch.h"
+
+// One product as the read paths see it: the row plus its encoded JSON
+struct CatalogEntry {
+    Product product;
+    std::string json;
+};
+
+// Column-oriented copy of a snapshot for predicate scans; row i is entries[i].
+// Categories and statuses are dictionary-encoded.
+struct ProductColumns {
+    static constexpr uint32_t kNoCategory = UINT32_MAX;
+
+    std::vector<int32_t> stock;
+    std::vector<int32_t> threshold;
+    std::vector<double> price;
+    std::vector<uint32_t> category;     // index into CatalogSnapshot::categories
+    std::vector<uint8_t> status;        // ProductStatus
+};
+
+// Server-side filter; unset fields match everything
+struct ProductFilter {
+    std::optional<int> minStock;
+    std::optional<int> maxStock;
+    std::optional<double> minPrice;
+    std::optional<double> maxPrice;
+    bool belowThreshold = false;        // stock < threshold
+    std::optional<std::string> category;
+    std::optional<ProductStatus> status;
+};
+
+// Immutable version of the whole catalog. Entries are shared between
+// consecutive snapshots; a snapshot and everything it points to stay valid
+// for as long as the reader's Epoch::Guard is held.
+struct CatalogSnapshot {
+    uint64_t version = 0;
+    std::vector<const CatalogEntry*> entries;                  // ordered by product id
+    std::vector<std::pair<std::string, size_t>> categories;    // name -> product count, ordered by name
+    size_t jsonBytes = 0;
+
+    CatalogSnapshot() = default;
+    CatalogSnapshot(const CatalogSnapshot& other);             // copies everything but the columns
+    CatalogSnapshot& operator=(const CatalogSnapshot&) = delete;
+    ~CatalogSnapshot();
+
+    const CatalogEntry* find(std::string_view id) const;
+
+    // Built on first use and kept for the life of the snapshot
+    const ProductColumns& columns() const;
+
+    // Writer side: patch `previous`'s columns for one row change at `row`
+    // (+1 inserted, -1 erased, 0 replaced) instead of rebuilding them later
+    void inheritColumns(const CatalogSnapshot& previous, size_t row, int change);
+
+private:
+    mutable std::atomic<const ProductColumns*> columnCache{nullptr};
+};
+
+struct CatalogStats {
+    uint64_t version;
+    size_t products;
+    size_t categories;
+    size_t jsonBytes;
+};
+
+// In-memory copy of the products table for the read endpoints.
+//
+// Readers load the current snapshot through an atomic pointer inside an
+// Epoch::Guard and never lock. Writers are serialized: each change, or batch
+// of changes, copies the entry index once, swaps the new snapshot in and
+// retires the old one (and any replaced entries) through Epoch.
+namespace Catalog {
+    void rebuild(const std::vector<Product>& products);
+
+    // Applies one committed row; std::nullopt removes the product
+    void apply(const std::string& id, const std::optional<Product>& row);
+
+    // Applies a batch of committed rows as one new snapshot, so the index is
+    // copied once per batch rather than once per row
+    void apply(const std::vector<std::pair<std::string, std::optional<Product>>>& rows);
+
+    // Until the first rebuild() callers must fall back to SQLite
+    bool loaded();
+
+    // Current snapshot; only valid while the caller holds an Epoch::Guard
+    const CatalogSnapshot* current();
+
+    // Copying conveniences for callers that do not want to hold a guard
+    std::optional<Product> find(const std::string& id);
+    std::vector<Product> products();
+    std::vector<std::string> categories();
+
+    // The product list as a JSON array (id order); false until loaded
+    bool writeProductListJson(std::string& out);
+
+    // Evaluates `filter` over the columns and writes {"total": n, "items": [first `limit` matches]};
+    // false until loaded
+    bool writeFilterJson(const ProductFilter& filter, size_t limit, JsonWriter& out);
+
+    CatalogStats stats();
+}
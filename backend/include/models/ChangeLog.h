@@ -0,0 +1,53 @@
+#ifndef CHANGE_LOG_H
+#define CHANGE_LOG_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ChangeLogOptions {
+    std::chrono::seconds compactEvery{3600};
+    std::chrono::hours retainFor{24 * 7};     // entries older than this are dropped...
+    uint64_t retainEntries = 1000000;         // ...as are all but this many of the newest (at least one is kept)
+};
+
+struct ProductChange {
+    uint64_t seq;
+    std::string op;          // insert, update or delete
+    std::string productId;
+    std::string changedAt;
+};
+
+enum class ChangeReadResult {
+    OK,
+    COMPACTED,   // entries after `since` were already dropped; the client has to refetch
+    FAILED
+};
+
+struct ChangeLogStats {
+    uint64_t latest;     // highest seq written
+    uint64_t oldest;     // lowest seq still stored, 0 when empty
+    uint64_t compacted;  // entries dropped since start
+};
+
+// Reader and compactor for the product_changes table, which triggers on
+// products fill in the same transaction as each write (see db/Schema.cpp).
+namespace ChangeLog {
+    // Starts the compaction thread
+    void start(const ChangeLogOptions& options = {});
+    void stop();
+
+    // Up to `limit` entries with seq > since, oldest first; `latest` is the
+    // highest seq written so far, which a client can store as its next `since`
+    // once it has caught up.
+    ChangeReadResult read(uint64_t since, size_t limit, std::vector<ProductChange>& out, uint64_t& latest);
+
+    // Drops entries past the retention limits; returns how many went
+    size_t compact();
+
+    ChangeLogStats stats();
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef EXPORT_CACHE_H
+#define EXPORT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ExportArtifact {
+    std::string path;
+    uint64_t generation = 0;   // DataVersion generation it was written at
+    uint64_t size = 0;
+    size_t rows = 0;
+};
+
+// Products CSV exports kept as files under exports/, one per DataVersion
+// generation and never modified once written. Requests reuse the current
+// file until a write bumps the generation; the next request then writes a
+// new one with exportProductsCsv while any others wait for it.
+namespace ExportCache {
+    bool productsCsv(ExportArtifact& out);
+
+    // `length` bytes from `offset` into memory, for range requests; callers cap `length`
+    bool read(const ExportArtifact& artifact, uint64_t offset, uint64_t length, std::string& out);
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef HOT_STOCK_H
+#define HOT_STOCK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct HotStockOptions {
+    std::chrono::milliseconds flushInterval{100};   // longest an accepted delta stays in memory only
+    size_t shards = 0;                              // counters per product; 0 = one per hardware thread
+    std::function<void(const std::string&)> onFlushed;   // after a flush changed stored stock
+};
+
+enum class HotDeltaResult {
+    NOT_HOT,        // take the normal write path
+    APPLIED,
+    EXHAUSTED,      // headroom used up, but there is more stock; a flush refills it
+    INSUFFICIENT    // not enough stock
+};
+
+struct HotProductStats {
+    std::string productId;
+    int64_t headroom;
+    int64_t budget;       // picks that can still be accepted before the next flush
+    int64_t pending;      // net delta not yet written
+    int64_t flushedStock; // stored stock after the last flush
+    uint64_t flushes;
+};
+
+// Write-behind stock counters for products under heavy contention. Each hot
+// product gets a set of sharded counters; a delta only locks the calling
+// thread's shard and is written to SQLite, through the stock ledger, by the
+// next periodic flush as one movement per product.
+//
+// Oversell protection: picks draw on a budget of at most `headroom` units that
+// never exceeds the stock known to exist, refilled after each flush.
+//
+// Durability: accepted deltas are lost if the process dies before the next
+// flush, so at most one flush interval of them. hot_stock.flushed_at marks what
+// made it to disk, and the product is hot again after a restart; the ledger's
+// "hot-flush" entries show exactly what each flush wrote.
+namespace HotStock {
+    // Starts the flush thread and re-promotes the products listed in hot_stock
+    void start(const HotStockOptions& options = {});
+    // Flushes everything and stops
+    void stop();
+
+    // False if the product doesn't exist
+    bool promote(const std::string& productId, int64_t headroom);
+    // Flushes and returns the product to the normal write path
+    bool demote(const std::string& productId);
+
+    HotDeltaResult apply(const std::string& productId, int delta);
+
+    // Writes the product's pending deltas now; true if it wasn't hot
+    bool flush(const std::string& productId);
+
+    // Runs a direct stock write for a product with no deltas in flight: pending
+    // deltas are flushed first, picks wait until `write` returns and the budget
+    // is rebuilt from the new stock. Just runs `write` if the product isn't hot.
+    bool exclusive(const std::string& productId, const std::function<bool()>& write);
+
+    std::vector<HotProductStats> stats();
+}
+
+#endif
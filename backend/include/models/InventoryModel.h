@@ -5,21 +5,49 @@
 #include <string>
 #include "models/ProductModel.h"
 
+// Rows are written by the alert triggers in db/Schema.cpp
 struct InventoryAlert {
-    int id;
-    int productId;     // Use camelCase consistently
+    std::string id;
+    std::string productId;     // Use camelCase consistently
+    std::string type;          // low-stock, out-of-stock or overstock
+    std::string severity;      // high, medium or low
     std::string message;
-    int threshold;
     std::string createdAt;
 };
 
+// Why stock moved; stored in stock_movements.kind
+enum class MovementKind {
+    RECEIVE,    // delta > 0
+    PICK,       // delta < 0
+    ADJUST,
+    TRANSFER
+};
+
+bool parseMovementKind(const std::string& s, MovementKind& kind);
+const char* movementKindName(MovementKind kind);
+
+enum class StockDeltaResult {
+    APPLIED,
+    NOT_FOUND,
+    INSUFFICIENT,   // would leave stock below zero
+    FAILED
+};
+
+class JsonWriter;
+
 namespace InventoryModel {
-    std::vector<Product> fetchInventoryOverview();
+    // Streams the overview as a JSON array straight from the cursor
+    void writeInventoryOverviewJson(JsonWriter& out);
     std::vector<InventoryAlert> fetchInventoryAlerts();
-    bool deleteInventoryAlert(int alertId);
-    bool updateStockQuantity(int productId, int newQuantity);
-    bool importCSV(const std::string& filePath);
-    bool exportCSV(const std::string& filePath);
+    bool deleteInventoryAlert(const std::string& alertId);
+    // Sets an absolute quantity; the ledger records the difference as an adjust.
+    // APPLIED, NOT_FOUND or FAILED.
+    StockDeltaResult updateStockQuantity(const std::string& productId, int newQuantity);
+    // stock = stock + delta in one statement, recorded in the ledger in the same transaction
+    StockDeltaResult applyStockDelta(const std::string& productId, MovementKind kind, int delta,
+                                     const std::string& reference, int& newStock);
+    // Newest first, as a JSON array
+    void writeStockMovementsJson(JsonWriter& out, const std::string& productId, size_t limit);
 }
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef LIVE_FEED_H
+#define LIVE_FEED_H
+
+#include "models/Product.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+struct LiveFeedOptions {
+    std::chrono::milliseconds flushInterval{50};   // how long a change may wait to be batched with others
+    size_t window = 8;                             // frames a client may leave unacknowledged
+    size_t maxPending = 1024;                      // coalesced events held for a stalled client before it must resync
+    std::chrono::seconds ackTimeout{30};           // a client silent this long with frames outstanding is closed
+};
+
+struct LiveFeedStats {
+    uint64_t clients;
+    uint64_t events;       // changes published by writers
+    uint64_t frames;       // frames handed to clients
+    uint64_t resyncs;      // clients told to refetch after overflowing
+    uint64_t disconnects;  // clients closed for not acknowledging
+};
+
+// Push channel for stock, product and alert changes (WebSocket /api/live).
+//
+// Writers only record which product or alert changed and return; they never
+// wait on clients. A single publisher thread wakes every flushInterval,
+// renders each changed key once from the catalog snapshot, and fans the
+// result out. Every client has its own pending set keyed by product/alert,
+// so repeated changes to one item collapse into its latest state. A client
+// gets at most `window` frames ahead of its acks; past that its changes
+// keep coalescing, and once more than maxPending keys pile up they are
+// dropped for a single {"resync":true} frame.
+//
+// Frames: {"seq":N,"events":[...]} or {"seq":N,"resync":true}; clients
+// answer {"ack":N}. Events:
+//   {"type":"stock","id","stock","threshold","status"}
+//   {"type":"product","product":{...}}          same shape as GET /api/products/<id>
+//   {"type":"product-removed","id"}
+//   {"type":"alerts","product_id","alerts":[...]} the product's open alerts
+//   {"type":"alert-dismissed","id"}
+namespace LiveFeed {
+    void start(const LiveFeedOptions& options = {});
+    void stop();
+
+    // Writer side. productWritten must run before Catalog::apply, since it
+    // compares `row` against the published entry to decide what changed.
+    void productWritten(const std::string& id, const std::optional<Product>& row);
+    void alertDismissed(const std::string& alertId);
+    // Bulk reloads: every client refetches instead of receiving deltas
+    void resyncAll();
+
+    // Client side. `send` and `close` are only called from the publisher
+    // thread, and never after unsubscribe() has returned.
+    uint64_t subscribe(std::function<void(const std::string&)> send, std::function<void()> close);
+    void unsubscribe(uint64_t client);
+    void acknowledge(uint64_t client, uint64_t seq);
+
+    LiveFeedStats stats();
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+#include "models/Product.h"
+
+struct LowStockItem {
+    std::string id;
+    double ratio;       // stock / threshold; 0 or below means out of stock
+};
+
+// Products ordered by how urgently they need reordering (stock / threshold,
+// lowest first). Only products that can ever be low are kept: threshold > 0,
+// or nothing left in stock. Maintained from the product cache hooks, so each
+// committed write costs O(log n) and reading the top K costs O(K).
+namespace LowStockIndex {
+    void rebuild(const std::vector<Product>& products);
+
+    // Re-keys one product after a committed write; std::nullopt removes it
+    void apply(const std::string& id, const std::optional<Product>& row);
+
+    // Most critical first, at most `limit`, stopping at the first ratio above `maxRatio`
+    std::vector<LowStockItem> top(size_t limit, double maxRatio);
+
+    size_t size();
+}
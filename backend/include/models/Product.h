@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+
+enum class ProductStatus {
+    IN_STOCK,    // corresponds to 'in-stock'
+    LOW_STOCK,   // corresponds to 'low-stock'
+    OUT_OF_STOCK,
+    UNKNOWN
+};
+
+inline ProductStatus parseStatus(const std::string& s) {
+    if (s == "in-stock") return ProductStatus::IN_STOCK;
+    if (s == "low-stock") return ProductStatus::LOW_STOCK;
+    if (s == "out-of-stock") return ProductStatus::OUT_OF_STOCK;
+    return ProductStatus::UNKNOWN;
+}
+
+inline std::string statusToString(ProductStatus status) {
+    switch (status) {
+        case ProductStatus::IN_STOCK: return "in-stock";
+        case ProductStatus::LOW_STOCK: return "low-stock";
+        case ProductStatus::OUT_OF_STOCK: return "out-of-stock";
+        default: return "unknown";
+    }
+}
+
+// Status is derived from stock and threshold on every write, never taken from clients
+inline ProductStatus deriveStatus(int stock, int threshold) {
+    if (stock <= 0) return ProductStatus::OUT_OF_STOCK;
+    if (stock <= threshold) return ProductStatus::LOW_STOCK;
+    return ProductStatus::IN_STOCK;
+}
+
+// SQL twin of deriveStatus() for statements that only know some of the values,
+// e.g. derivedStatusSql("?1", "threshold")
+std::string derivedStatusSql(const std::string& stock, const std::string& threshold);
+
+struct Product {
+    std::string id;
+    std::string name;
+    std::string sku;
+    std::string category;
+    std::string description;
+    std::string barcode;
+    int stock;
+    int threshold;
+    double price;
+    ProductStatus status;
+};
+
+class JsonWriter;
+
+// The object shape every product endpoint returns
+void writeProductJson(JsonWriter& out, const Product& p);
+std::string encodeProductJson(const Product& p);
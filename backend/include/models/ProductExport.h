@@ -0,0 +1,23 @@
+#ifndef PRODUCT_EXPORT_H
+#define PRODUCT_EXPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+struct ExportReport {
+    size_t rows = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+};
+
+// Writes every product to `out` as CSV: a header row with the columns the
+// products import reads, then one quoted row per product.
+//
+// Rows go straight from the SQLite cursor through a fixed-size buffer, so
+// memory doesn't grow with the catalog. The query runs in one read
+// transaction; in WAL mode writers carry on meanwhile, and the file shows
+// the catalog exactly as of the transaction's start.
+bool exportProductsCsv(std::FILE* out, ExportReport& report);
+
+#endif
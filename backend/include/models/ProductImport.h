@@ -0,0 +1,38 @@
+#ifndef PRODUCT_IMPORT_H
+#define PRODUCT_IMPORT_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ImportOptions {
+    size_t batchRows = 1000;        // rows per write-queue op; keeps other writers waiting well under 100 ms
+    size_t maxErrors = 100;         // row errors kept for the report; the rest are only counted
+    size_t parserThreads = 0;       // 0 = one per core, less one for the writer
+    size_t chunkBytes = 1 << 20;    // input is split at the first record boundary past each multiple of this
+    size_t queueChunks = 8;         // parsed chunks allowed to wait for the writer
+    bool dryRun = false;            // parse and validate only; `imported` counts the rows that would be written
+};
+
+struct ImportReport {
+    std::string headerError;    // set when the file can't be imported at all
+    size_t rows = 0;            // data rows read
+    size_t imported = 0;
+    size_t failed = 0;
+    double seconds = 0;
+    std::vector<std::string> errors;   // "line N: reason"
+};
+
+// Imports a products CSV held in memory: a header row naming id, name, sku,
+// barcode, category, stock, threshold and price (other columns, e.g. status,
+// are ignored), then one product per row. An empty id gets a generated one.
+// Fields may be quoted as in RFC 4180, so an export reads back unchanged.
+//
+// The rows are split into record-aligned chunks that a pool of threads parses
+// and validates; the calling thread takes the results in file order and
+// inserts them in batches, each one transaction through one prepared
+// statement. A row that fails (duplicate sku, ...) doesn't affect the others.
+ImportReport importProductsCsv(std::string_view csv, const ImportOptions& options = {});
+
+#endif
@@ -3,33 +3,7 @@
 #include <string>
 #include <optional>
 #include "crow.h"
-
-enum class ProductStatus {
-    IN_STOCK,    // corresponds to 'in-stock'
-    LOW_STOCK,   // corresponds to 'low-stock'
-    OUT_OF_STOCK,
-    UNKNOWN
-};
-
-inline ProductStatus parseStatus(const std::string& s) {
-    if (s == "in-stock") return ProductStatus::IN_STOCK;
-    if (s == "low-stock") return ProductStatus::LOW_STOCK;
-    if (s == "out-of-stock") return ProductStatus::OUT_OF_STOCK;
-    return ProductStatus::UNKNOWN;
-}
-
-struct Product {
-    std::string id;
-    std::string name;
-    std::string sku;
-    std::string category;
-    std::string description;
-    std::string barcode;
-    int stock;
-    int threshold;
-    double price;
-    ProductStatus status;
-};
+#include "models/Product.h"
 
 // DB operations
 bool insertProduct(
@@ -40,8 +14,7 @@ bool insertProduct(
     const std::string& category,
     int stock,
     int threshold,
-    double price,
-    ProductStatus status
+    double price
 );
 
 std::vector<Product> getAllProductsFromDB();
@@ -49,6 +22,23 @@ std::optional<Product> getProductByIdFromDB(const std::string& id);
 std::optional<Product> getProductByBarcode(const std::string& barcode);
 std::vector<Product> searchProducts(const std::string& query);
 
+class JsonWriter;
+
+// Streaming serialization: rows are encoded as a JSON array straight from the cursor
+void writeAllProductsJson(JsonWriter& out);
+void writeSearchResultsJson(JsonWriter& out, const std::string& query);
+
+// Keyset pagination: one page of rows starting after `after` ("" = first page). Returns the
+// cursor to resume from when another page follows. The list is ordered by id; search results
+// by relevance, with a cursor that is only meaningful for the same query.
+std::optional<std::string> writeProductsPageJson(JsonWriter& out, const std::string& afterId, int limit);
+std::optional<std::string> writeSearchPageJson(JsonWriter& out, const std::string& query, const std::string& after, int limit);
+
+// Batch lookup: resolves all keys with one set-based query and writes
+// [{"key": k, "found": true, "product": {...}} | {"key": k, "found": false}, ...] in input order
+enum class ProductKey { ID, SKU, BARCODE };
+void writeProductLookupJson(JsonWriter& out, ProductKey by, const std::vector<std::string>& keys);
+
 // Serialization
 crow::json::wvalue serializeProductsToJson(const std::vector<Product>& products);
 crow::json::wvalue productToJson(const Product& p);
@@ -62,12 +52,40 @@ bool updateProductInDB(
     const std::string& category,
     int stock,
     int threshold,
-    double price,
-    ProductStatus status
+    double price
 );
 
+// Partial update: only the supplied fields are written, and only if one of them differs
+struct ProductPatch {
+    std::optional<std::string> name;
+    std::optional<std::string> sku;
+    std::optional<std::string> barcode;
+    std::optional<std::string> category;
+    std::optional<std::string> description;
+    std::optional<int> stock;
+    std::optional<int> threshold;
+    std::optional<double> price;
+};
+enum class PatchResult { UPDATED, UNCHANGED, NOT_FOUND, CONFLICT, FAILED };
+PatchResult patchProductInDB(const std::string& id, const ProductPatch& patch);
+
 bool deleteProductFromDB(const std::string& id);
+
+// Bulk create/update keyed by SKU, all rows in one transaction. Rows without an id get a new UUID;
+// each row's status is derived from its stock and threshold.
+struct BulkRowResult {
+    bool ok = false;
+    bool inserted = false;      // false: an existing SKU was updated
+    std::string id;
+    std::string error;
+};
+std::vector<BulkRowResult> bulkUpsertProducts(const std::vector<Product>& products);
+
+// Called after a committed write: updates state derived from the products table
+// (barcode index, catalog snapshot, low-stock index, live feed) and bumps DataVersion
+void loadProductCaches();
+void refreshProductCaches(const std::string& id);
+void refreshProductCaches(const std::vector<std::string>& ids);
 std::vector<std::string> getAllCategoriesFromDB();
-std::string statusToString(ProductStatus status);
 
 
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ResponseCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    size_t entries;
+    size_t bytes;       // cached bodies + keys
+};
+
+// Pre-serialized JSON for the hot read endpoints.
+//
+// Whole bodies are cached per route + query string and stamped with the
+// DataVersion generation they were built at, so any committed write makes
+// them stale. Rebuilding the unpaged product list after a write is cheap:
+// Catalog keeps every product's JSON and only re-encodes the rows that changed.
+namespace ResponseCache {
+    // Body cached under `key` at exactly `generation`
+    bool get(const std::string& key, uint64_t generation, std::string& body);
+    void put(const std::string& key, uint64_t generation, const std::string& body);
+
+    ResponseCacheStats stats();
+}
@@ -0,0 +1,51 @@
+#ifndef STOCK_LEDGER_H
+#define STOCK_LEDGER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LedgerReplay {
+    uint64_t snapshotId = 0;           // 0 when replayed from the first movement
+    uint64_t throughMovement = 0;      // last movement included
+    uint64_t movementsReplayed = 0;    // movements after the snapshot
+    std::unordered_map<std::string, int64_t> stock;
+};
+
+struct LedgerDrift {
+    std::string productId;
+    int64_t stored;   // products.stock as of throughMovement
+    int64_t ledger;
+};
+
+// Snapshots and replay of the stock_movements ledger (see db/Schema.cpp).
+// Replay starts from the newest snapshot, so its cost is bounded by the
+// movements written since, not by the age of the ledger.
+namespace StockLedger {
+    // Records every product's stock through the newest movement, in one write
+    // transaction, and keeps only the newest `keep` snapshots.
+    bool snapshot(size_t keep = 2);
+
+    // Newest snapshot plus the movements after it. The movement id range is
+    // split across `threads` readers, each on its own pooled connection.
+    bool replay(size_t threads, LedgerReplay& out);
+
+    // Products whose stored stock disagrees with the replay. Movements written
+    // after the replay are taken out of the stored value before comparing.
+    bool compare(const LedgerReplay& replay, std::vector<LedgerDrift>& drift);
+
+    // Moves stored stock onto the ledger's value without writing new movements;
+    // for products that no longer exist, an adjustment closes the ledger instead.
+    // Product caches are not refreshed; callers in the server must do that.
+    bool correct(const std::vector<LedgerDrift>& drift);
+
+    // Background snapshots: every `interval`, take one if `every` movements
+    // have accumulated since the last.
+    void start(uint64_t every, std::chrono::seconds interval);
+    void stop();
+}
+
+#endif
@@ -0,0 +1,5 @@
+#pragma once
+#include "crow.h"
+
+template <typename App>
+void setupLiveRoutes(App& app);
@@ -0,0 +1,51 @@
+#ifndef BYTE_RANGE_H
+#define BYTE_RANGE_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+// Inclusive byte offsets
+struct ByteRange {
+    uint64_t first;
+    uint64_t last;
+};
+
+enum class RangeMatch { NONE, SATISFIABLE, UNSATISFIABLE };
+
+// Reads a Range header against a body of `size` bytes. Only a single range is
+// served; several ranges, other units or bad syntax give NONE, i.e. the whole
+// body, which RFC 9110 allows.
+inline RangeMatch parseRange(std::string_view header, uint64_t size, ByteRange& range) {
+    constexpr std::string_view unit = "bytes=";
+    if (header.substr(0, unit.size()) != unit) return RangeMatch::NONE;
+    header.remove_prefix(unit.size());
+    size_t dash = header.find('-');
+    if (dash == std::string_view::npos || header.find(',') != std::string_view::npos) return RangeMatch::NONE;
+
+    auto number = [](std::string_view v, uint64_t& out) {
+        auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+        return !v.empty() && ec == std::errc() && end == v.data() + v.size();
+    };
+    std::string_view from = header.substr(0, dash);
+    std::string_view to = header.substr(dash + 1);
+
+    // "-n": the last n bytes
+    if (from.empty()) {
+        uint64_t n;
+        if (!number(to, n)) return RangeMatch::NONE;
+        if (n == 0 || size == 0) return RangeMatch::UNSATISFIABLE;
+        range = {size - std::min(n, size), size - 1};
+        return RangeMatch::SATISFIABLE;
+    }
+
+    uint64_t first, last = UINT64_MAX;
+    if (!number(from, first)) return RangeMatch::NONE;
+    if (!to.empty() && (!number(to, last) || last < first)) return RangeMatch::NONE;
+    if (first >= size) return RangeMatch::UNSATISFIABLE;
+    range = {first, std::min(last, size - 1)};
+    return RangeMatch::SATISFIABLE;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Predicate kernels over plain column arrays.
+//
+// A filter starts from all() and every predicate ANDs its result into the
+// mask (one bit per row, 64 rows per word); select() turns the surviving
+// bits into a selection vector of row indexes. On x86 the kernels use AVX2
+// when the CPU has it and fall back to scalar loops otherwise.
+namespace ColumnFilter {
+    enum class Isa { SCALAR, AVX2 };
+
+    // Kernel set in use; useIsa() is for benchmarks and ignores unsupported choices
+    Isa isa();
+    void useIsa(Isa requested);
+
+    using Mask = std::vector<uint64_t>;
+
+    Mask all(size_t rows);
+
+    // lo <= col[i] <= hi
+    void between(const int32_t* col, size_t rows, int32_t lo, int32_t hi, Mask& mask);
+    void between(const double* col, size_t rows, double lo, double hi, Mask& mask);
+
+    // a[i] < b[i]
+    void less(const int32_t* a, const int32_t* b, size_t rows, Mask& mask);
+
+    // col[i] == value (dictionary codes)
+    void equals(const uint32_t* col, size_t rows, uint32_t value, Mask& mask);
+    void equals(const uint8_t* col, size_t rows, uint8_t value, Mask& mask);
+
+    size_t count(const Mask& mask);
+
+    // Appends the indexes of set bits in ascending order, stopping after `limit`
+    void select(const Mask& mask, std::vector<uint32_t>& selection, size_t limit = SIZE_MAX);
+}
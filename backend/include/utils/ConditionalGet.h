@@ -0,0 +1,59 @@
+#ifndef CONDITIONAL_GET_H
+#define CONDITIONAL_GET_H
+
+#include "crow.h"
+#include "db/DataVersion.h"
+#include "models/ResponseCache.h"
+#include <string>
+#include <string_view>
+
+// True when If-None-Match lists `etag` (weak or strong) or is "*"
+inline bool ifNoneMatch(const crow::request& req, const std::string& etag) {
+    std::string_view header = req.get_header_value("If-None-Match");
+    while (!header.empty()) {
+        size_t comma = header.find(',');
+        std::string_view tag = header.substr(0, comma);
+        while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+        while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+        if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+        if (tag == "*" || tag == etag) return true;
+        if (comma == std::string_view::npos) break;
+        header.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+// Serves `build()` with an ETag for the current data generation, or a bare 304
+// when the client already holds it. 200 bodies are kept in ResponseCache under
+// the URL (path + query) until the next write. The generation is read before
+// the data so a concurrent write can only make the tag older than the body,
+// never newer.
+template <typename Build>
+crow::response conditionalGet(const crow::request& req, Build build) {
+    uint64_t generation = DataVersion::current();
+    std::string etag = DataVersion::etag(generation);
+    if (ifNoneMatch(req, etag)) {
+        crow::response res(304);
+        res.set_header("ETag", etag);
+        res.set_header("Cache-Control", "no-cache");
+        return res;
+    }
+
+    crow::response res;
+    if (ResponseCache::get(req.raw_url, generation, res.body)) {
+        res.code = 200;
+        res.set_header("Content-Type", "application/json");
+    } else {
+        res = build();
+        if (res.code == 200) ResponseCache::put(req.raw_url, generation, res.body);
+    }
+
+    if (res.code == 200) {
+        res.set_header("ETag", etag);
+        // Let browsers keep the body but revalidate on every use
+        res.set_header("Cache-Control", "no-cache");
+    }
+    return res;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// RFC 4180 CSV tokenizer over a buffer held in memory.
+//
+// The input is classified 64 bytes at a time into bitmasks of quotes, commas
+// and line feeds; a prefix XOR over the quote bits marks what lies inside
+// quotes, so the separators left over are the field and record boundaries.
+// On x86 the classification uses AVX2 when the CPU has it.
+//
+// Fields are trimmed of spaces and tabs (and the \r of a CRLF). A field that
+// starts with a quote has its enclosing quotes removed and "" turned into ";
+// quoted fields may contain commas and line breaks.
+class CsvReader {
+public:
+    enum class Isa { SCALAR, AVX2 };
+
+    // Kernel set in use; useIsa() is for benchmarks and ignores unsupported choices
+    static Isa isa();
+    static void useIsa(Isa requested);
+
+    // Offset just past the first record boundary at or after `from + target`,
+    // or data.size(). `from` must be at the start of a record.
+    static size_t recordBoundary(std::string_view data, size_t from, size_t target);
+
+    explicit CsvReader(std::string_view data);
+
+    // Reads the next record; false at the end of the input. The views point
+    // into the input, or into the reader for fields that had "" escapes, and
+    // stay valid until the next call.
+    bool next(std::vector<std::string_view>& fields);
+
+    // Line the last record started on (1-based), lines read so far and the
+    // offset just past the last record
+    unsigned line() const { return recordLine; }
+    unsigned lines() const { return nextLine - 1; }
+    size_t offset() const { return pos; }
+
+    // The last record ran to the end of the input inside a quoted field
+    bool unterminated() const { return openQuote; }
+
+private:
+    std::string_view field(const char* begin, const char* end);
+
+    std::string_view data;
+    size_t pos = 0;
+    size_t block = 0;             // offset of the block `separators` covers
+    uint64_t separators = 0;      // its separators not consumed yet
+    uint64_t inQuotes = 0;        // all ones when that block ends inside quotes
+    bool openQuote = false;
+    unsigned recordLine = 0;
+    unsigned nextLine = 1;
+    std::deque<std::string> unescaped;
+};
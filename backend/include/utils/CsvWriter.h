@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+// Formats CSV rows into a fixed-size buffer that is written to a stdio stream
+// whenever it fills, so memory stays flat however many rows go through.
+// Text is always quoted, with " doubled (RFC 4180), which CsvReader reads
+// back unchanged; numbers go through std::to_chars.
+class CsvWriter {
+public:
+    explicit CsvWriter(std::FILE* out, size_t bufferBytes = 64 * 1024);
+    ~CsvWriter() { flush(); }
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    void value(std::string_view s);
+    void value(const char* s) { value(std::string_view(s ? s : "")); }
+    void value(int64_t n);
+    void value(int n) { value(static_cast<int64_t>(n)); }
+    void value(double d);
+    void endRow();
+
+    // Already-formatted CSV, e.g. a header line
+    void raw(std::string_view s) { append(s.data(), s.size()); }
+
+    // Writes out what is buffered; false once any write has failed
+    bool flush();
+    uint64_t bytes() const { return written + used; }
+
+private:
+    void separate() {
+        if (rowStarted) put(',');
+        rowStarted = true;
+    }
+    void put(char c) {
+        if (used == buf.size()) flush();
+        buf[used++] = c;
+    }
+    void append(const char* data, size_t n);
+
+    std::FILE* out;
+    std::vector<char> buf;
+    size_t used = 0;
+    uint64_t written = 0;
+    bool rowStarted = false;
+    bool failed = false;
+};
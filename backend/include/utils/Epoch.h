@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Epoch-based reclamation for structures that readers walk without locks.
+//
+// Readers wrap each access in an Epoch::Guard. Writers unlink an object, then
+// hand it to Epoch::retire(); it is destroyed once every reader that might
+// still hold a pointer to it has left its guard.
+namespace Epoch {
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        bool outermost;
+    };
+
+    // Schedules `destroy` to run once no guard that could see the object is active
+    void retire(std::function<void()> destroy);
+
+    template <typename T>
+    void retire(const T* object) {
+        retire([object] { delete object; });
+    }
+
+    // Runs whatever has become safe to destroy; returns how much is still pending
+    size_t collect();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Appends JSON tokens straight into a string buffer. Used for list endpoints
+// so rows go from the SQLite cursor to the response body without building a
+// crow::json::wvalue tree first.
+class JsonWriter {
+public:
+    JsonWriter() = default;
+    explicit JsonWriter(size_t reserve) { buf.reserve(reserve); }
+
+    void beginObject() { separate(); buf += '{'; needComma = false; }
+    void endObject() { buf += '}'; needComma = true; }
+    void beginArray() { separate(); buf += '['; needComma = false; }
+    void endArray() { buf += ']'; needComma = true; }
+
+    void key(std::string_view name);
+
+    void value(std::string_view s);
+    void value(const char* s);      // nullptr is written as null
+    void value(int64_t n);
+    void value(int n) { value(static_cast<int64_t>(n)); }
+    void value(uint64_t n);
+    void value(double d);
+    void value(bool b) { separate(); buf += b ? "true" : "false"; needComma = true; }
+    void null() { separate(); buf += "null"; needComma = true; }
+
+    // Already-encoded JSON value, e.g. a cached fragment
+    void raw(std::string_view json) { separate(); buf += json; needComma = true; }
+
+    const std::string& str() const { return buf; }
+    std::string take() { return std::move(buf); }
+
+private:
+    void separate() { if (needComma) buf += ','; }
+    void appendEscaped(std::string_view s);
+
+    std::string buf;
+    bool needComma = false;
+};
@@ -1,8 +1,25 @@
 #include "crow.h"
 #include "middleware/CorsMiddleware.h"
+#include "middleware/DbLeaseMiddleware.h"
 #include "routes/products_routes.h"
 #include "routes/inventory_routes.h"
+#include "routes/live_routes.h"
 #include "db/Database.h"
+#include "db/WriteQueue.h"
+#include "models/ProductModel.h"
+#include "models/ResponseCache.h"
+#include "models/Catalog.h"
+#include "models/ChangeLog.h"
+#include "models/LiveFeed.h"
+#include "models/StockLedger.h"
+#include "models/HotStock.h"
+#include <cstdlib>
+
+// Reads a numeric setting from the environment, falling back to `fallback`
+static long envOr(const char* name, long fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtol(value, nullptr, 10) : fallback;
+}
 
 int main() {
     std::string dbPath = std::filesystem::current_path().parent_path().string() + "/data/inventory.db";
@@ -11,15 +28,84 @@ int main() {
         return 1;
     }
 
-    crow::App<CORSHandler> app;
+    // Group commit for mutations: INVENTORY_WRITE_BATCH ops per commit, waiting at most INVENTORY_WRITE_WAIT_US
+    WriteQueueOptions writeOptions;
+    writeOptions.maxBatch = static_cast<size_t>(envOr("INVENTORY_WRITE_BATCH", 256));
+    writeOptions.maxWait = std::chrono::microseconds(envOr("INVENTORY_WRITE_WAIT_US", 1000));
+    WriteQueue::start(writeOptions);
+
+    loadProductCaches();
+    Database::release();
+
+    // Push channel: changes are batched for INVENTORY_LIVE_FLUSH_MS before fan-out
+    LiveFeedOptions liveOptions;
+    liveOptions.flushInterval = std::chrono::milliseconds(envOr("INVENTORY_LIVE_FLUSH_MS", 50));
+    LiveFeed::start(liveOptions);
+
+    // Change log retention: INVENTORY_CHANGES_RETAIN_H hours, at most INVENTORY_CHANGES_RETAIN entries
+    ChangeLogOptions changeOptions;
+    changeOptions.retainFor = std::chrono::hours(envOr("INVENTORY_CHANGES_RETAIN_H", 24 * 7));
+    changeOptions.retainEntries = static_cast<uint64_t>(envOr("INVENTORY_CHANGES_RETAIN", 1000000));
+    ChangeLog::start(changeOptions);
+
+    // Ledger snapshots, so replay covers at most ~INVENTORY_SNAPSHOT_EVERY movements past the newest one
+    StockLedger::start(static_cast<uint64_t>(envOr("INVENTORY_SNAPSHOT_EVERY", 100000)), std::chrono::seconds(60));
+
+    // Hot products' stock deltas reach SQLite at most INVENTORY_HOT_FLUSH_MS after they are accepted
+    HotStockOptions hotOptions;
+    hotOptions.flushInterval = std::chrono::milliseconds(envOr("INVENTORY_HOT_FLUSH_MS", 100));
+    hotOptions.onFlushed = [](const std::string& id) { refreshProductCaches(id); };
+    HotStock::start(hotOptions);
+
+    crow::App<CORSHandler, DbLeaseHandler> app;
 
     setupProductRoutes(app);
     setupInventoryRoutes(app);
+    setupLiveRoutes(app);
 
     CROW_ROUTE(app, "/api/health").methods("GET"_method)([]() {
         crow::json::wvalue result;
         result["status"] = "ok";
         result["timestamp"] = std::time(nullptr);
+
+        auto stmts = Database::statementStats();
+        uint64_t lookups = stmts.hits + stmts.misses;
+        result["db"]["connections"] = Database::openConnections();
+        result["db"]["statement_cache"]["hits"] = stmts.hits;
+        result["db"]["statement_cache"]["misses"] = stmts.misses;
+        result["db"]["statement_cache"]["hit_rate"] = lookups ? static_cast<double>(stmts.hits) / lookups : 0.0;
+        result["db"]["statement_cache"]["prepare_us"] = stmts.prepareNanos / 1000;
+
+        auto writes = WriteQueue::stats();
+        result["db"]["writes"]["operations"] = writes.operations;
+        result["db"]["writes"]["commits"] = writes.commits;
+        result["db"]["writes"]["failed_commits"] = writes.failedCommits;
+
+        auto responses = ResponseCache::stats();
+        uint64_t requests = responses.hits + responses.misses;
+        result["response_cache"]["hits"] = responses.hits;
+        result["response_cache"]["misses"] = responses.misses;
+        result["response_cache"]["hit_rate"] = requests ? static_cast<double>(responses.hits) / requests : 0.0;
+        result["response_cache"]["entries"] = responses.entries;
+        result["response_cache"]["bytes"] = responses.bytes;
+
+        auto catalog = Catalog::stats();
+        result["catalog"]["version"] = catalog.version;
+        result["catalog"]["products"] = catalog.products;
+        result["catalog"]["categories"] = catalog.categories;
+        result["catalog"]["json_bytes"] = catalog.jsonBytes;
+
+        auto changes = ChangeLog::stats();
+        result["changes"]["latest"] = changes.latest;
+        result["changes"]["oldest"] = changes.oldest;
+        result["changes"]["compacted"] = changes.compacted;
+
+        auto live = LiveFeed::stats();
+        result["live"]["clients"] = live.clients;
+        result["live"]["events"] = live.events;
+        result["live"]["frames"] = live.frames;
+        result["live"]["resyncs"] = live.resyncs;
+        result["live"]["disconnects"] = live.disconnects;
         return crow::response{result};
     });
 
@@ -29,4 +115,10 @@ int main() {
 
 
     app.port(8080).multithreaded().run();
+    HotStock::stop();
+    StockLedger::stop();
+    ChangeLog::stop();
+    LiveFeed::stop();
+    WriteQueue::stop();
+    Database::shutdown();
 }
@@ -0,0 +1,212 @@
+#include "models/BarcodeIndex.h"
+#include "utils/Epoch.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    // Never modified once published
+    struct Node {
+        std::string barcode;
+        Product product;
+        std::string json;
+        const Node* next;
+    };
+
+    struct Table {
+        size_t mask;
+        std::unique_ptr<std::atomic<const Node*>[]> buckets;
+
+        explicit Table(size_t capacity) : mask(capacity - 1), buckets(new std::atomic<const Node*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        std::atomic<const Node*>& bucket(std::string_view barcode) {
+            return buckets[std::hash<std::string_view>{}(barcode) & mask];
+        }
+    };
+
+    std::atomic<Table*> table{nullptr};
+    std::atomic<bool> isLoaded{false};
+
+    // Writer-side state
+    std::mutex writeMutex;
+    std::unordered_map<std::string, std::string> barcodeById;
+
+    size_t capacityFor(size_t count) {
+        size_t capacity = 1024;
+        while (capacity < count * 2) capacity <<= 1;
+        return capacity;
+    }
+
+    void retireChain(const Node* node) {
+        Epoch::retire([node] {
+            for (const Node* n = node; n;) {
+                const Node* next = n->next;
+                delete n;
+                n = next;
+            }
+        });
+    }
+
+    void retireTable(Table* old) {
+        if (!old) return;
+        Epoch::retire([old] {
+            for (size_t i = 0; i <= old->mask; ++i) {
+                for (const Node* n = old->buckets[i].load(std::memory_order_relaxed); n;) {
+                    const Node* next = n->next;
+                    delete n;
+                    n = next;
+                }
+            }
+            delete old;
+        });
+    }
+
+    // Copies the chain minus `barcode`, optionally prepending `replacement`. With `owner`
+    // only that product's node goes: another product may have taken the barcode since.
+    // Caller holds writeMutex.
+    void replaceInChain(Table* t, std::string_view barcode, Node* replacement, const std::string* owner = nullptr) {
+        auto& head = t->bucket(barcode);
+        const Node* old = head.load(std::memory_order_relaxed);
+
+        const Node* fresh = nullptr;
+        bool found = false;
+        for (const Node* n = old; n; n = n->next) {
+            if (n->barcode == barcode && (!owner || n->product.id == *owner)) {
+                found = true;
+                continue;
+            }
+            fresh = new Node{n->barcode, n->product, n->json, fresh};
+        }
+        if (!found && !replacement) {
+            // Nothing to remove; throw the copy away
+            for (const Node* n = fresh; n;) { const Node* next = n->next; delete n; n = next; }
+            return;
+        }
+        if (replacement) {
+            replacement->next = fresh;
+            fresh = replacement;
+        }
+
+        head.store(fresh, std::memory_order_release);
+        retireChain(old);
+    }
+
+    void insertLocked(const Product& p) {
+        Table* t = table.load(std::memory_order_relaxed);
+
+        // Grow before the table gets crowded; readers switch over on the next lookup
+        if (!t || barcodeById.size() + 1 > (t->mask + 1) / 2) {
+            auto* bigger = new Table(capacityFor(barcodeById.size() + 1));
+            if (t) {
+                for (size_t i = 0; i <= t->mask; ++i) {
+                    for (const Node* n = t->buckets[i].load(std::memory_order_relaxed); n; n = n->next) {
+                        auto& head = bigger->bucket(n->barcode);
+                        head.store(new Node{n->barcode, n->product, n->json, head.load(std::memory_order_relaxed)},
+                                   std::memory_order_relaxed);
+                    }
+                }
+            }
+            table.store(bigger, std::memory_order_release);
+            retireTable(t);
+            t = bigger;
+        }
+
+        replaceInChain(t, p.barcode, new Node{p.barcode, p, encodeProductJson(p), nullptr});
+        barcodeById[p.id] = p.barcode;
+    }
+
+    void removeLocked(const std::string& id) {
+        auto it = barcodeById.find(id);
+        if (it == barcodeById.end()) return;
+        Table* t = table.load(std::memory_order_relaxed);
+        if (t) replaceInChain(t, it->second, nullptr, &id);
+        barcodeById.erase(it);
+    }
+
+    // Swaps the entry for `id` in place, so readers never see the barcode missing mid-update
+    void putLocked(const std::string& id, const std::optional<Product>& product) {
+        if (!product || product->barcode.empty()) {
+            removeLocked(id);
+            return;
+        }
+
+        auto it = barcodeById.find(id);
+        std::string oldBarcode = it != barcodeById.end() ? it->second : std::string();
+        insertLocked(*product);
+        if (!oldBarcode.empty() && oldBarcode != product->barcode) {
+            replaceInChain(table.load(std::memory_order_relaxed), oldBarcode, nullptr, &id);
+        }
+    }
+
+    const Node* find(std::string_view barcode) {
+        Table* t = table.load(std::memory_order_acquire);
+        if (!t) return nullptr;
+        for (const Node* n = t->bucket(barcode).load(std::memory_order_acquire); n; n = n->next) {
+            if (n->barcode == barcode) return n;
+        }
+        return nullptr;
+    }
+}
+
+namespace BarcodeIndex {
+    void rebuild(const std::vector<Product>& products) {
+        auto* fresh = new Table(capacityFor(products.size()));
+        std::unordered_map<std::string, std::string> ids;
+        ids.reserve(products.size());
+
+        for (const auto& p : products) {
+            if (p.barcode.empty()) continue;
+            auto& head = fresh->bucket(p.barcode);
+            head.store(new Node{p.barcode, p, encodeProductJson(p), head.load(std::memory_order_relaxed)},
+                       std::memory_order_relaxed);
+            ids[p.id] = p.barcode;
+        }
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        barcodeById = std::move(ids);
+        retireTable(table.exchange(fresh, std::memory_order_acq_rel));
+        isLoaded = true;
+    }
+
+    void refresh(const std::string& id, const std::function<std::optional<Product>()>& load) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        putLocked(id, load());
+    }
+
+    void upsert(const Product& product) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        putLocked(product.id, product);
+    }
+
+    void remove(const std::string& id) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        removeLocked(id);
+    }
+
+    bool loaded() {
+        return isLoaded;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return barcodeById.size();
+    }
+
+    bool lookupJson(std::string_view barcode, std::string& json) {
+        Epoch::Guard guard;
+        const Node* n = find(barcode);
+        if (!n) return false;
+        json.assign(n->json);
+        return true;
+    }
+
+    std::optional<Product> lookup(std::string_view barcode) {
+        Epoch::Guard guard;
+        const Node* n = find(barcode);
+        if (!n) return std::nullopt;
+        return n->product;
+    }
+}
@@ -0,0 +1,330 @@
+#include "models/Catalog.h"
+#include "utils/ColumnFilter.h"
+#include "utils/JsonWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace {
+    std::atomic<const CatalogSnapshot*> published{nullptr};
+
+    // Serializes writers; readers never touch it
+    std::mutex writeMutex;
+
+    bool idLess(const CatalogEntry* entry, std::string_view id) {
+        return entry->product.id < id;
+    }
+
+    const CatalogEntry* makeEntry(const Product& p) {
+        return new CatalogEntry{p, encodeProductJson(p)};
+    }
+
+    using CategoryCounts = std::vector<std::pair<std::string, size_t>>;
+
+    // Position of `name` in the sorted list, or where it would go
+    size_t categorySlot(const CategoryCounts& categories, const std::string& name) {
+        auto it = std::lower_bound(categories.begin(), categories.end(), name,
+                                   [](const auto& c, const std::string& n) { return c.first < n; });
+        return static_cast<size_t>(it - categories.begin());
+    }
+
+    uint32_t categoryCode(const CategoryCounts& categories, const std::string& name) {
+        size_t slot = categorySlot(categories, name);
+        return slot < categories.size() && categories[slot].first == name
+            ? static_cast<uint32_t>(slot) : ProductColumns::kNoCategory;
+    }
+
+    // delta is +1 or -1
+    void countCategory(CategoryCounts& categories, const std::string& name, int delta) {
+        if (name.empty()) return;
+        auto it = categories.begin() + categorySlot(categories, name);
+        if (it != categories.end() && it->first == name) {
+            if (delta > 0) ++it->second;
+            else if (--it->second == 0) categories.erase(it);
+        } else if (delta > 0) {
+            categories.insert(it, {name, 1});
+        }
+    }
+
+    // Caller holds writeMutex. The old snapshot is retired, not its entries.
+    void publish(CatalogSnapshot* next) {
+        const CatalogSnapshot* old = published.exchange(next, std::memory_order_acq_rel);
+        if (old) Epoch::retire(old);
+    }
+}
+
+CatalogSnapshot::CatalogSnapshot(const CatalogSnapshot& other)
+    : version(other.version), entries(other.entries), categories(other.categories), jsonBytes(other.jsonBytes) {}
+
+CatalogSnapshot::~CatalogSnapshot() {
+    delete columnCache.load(std::memory_order_acquire);
+}
+
+const ProductColumns& CatalogSnapshot::columns() const {
+    if (const ProductColumns* built = columnCache.load(std::memory_order_acquire)) return *built;
+
+    auto* fresh = new ProductColumns;
+    size_t rows = entries.size();
+    fresh->stock.reserve(rows);
+    fresh->threshold.reserve(rows);
+    fresh->price.reserve(rows);
+    fresh->category.reserve(rows);
+    fresh->status.reserve(rows);
+    for (const CatalogEntry* entry : entries) {
+        const Product& p = entry->product;
+        fresh->stock.push_back(p.stock);
+        fresh->threshold.push_back(p.threshold);
+        fresh->price.push_back(p.price);
+        fresh->category.push_back(categoryCode(categories, p.category));
+        fresh->status.push_back(static_cast<uint8_t>(p.status));
+    }
+
+    // Concurrent first users may both build; the loser throws its copy away
+    const ProductColumns* expected = nullptr;
+    if (!columnCache.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+        delete fresh;
+        return *expected;
+    }
+    return *fresh;
+}
+
+void CatalogSnapshot::inheritColumns(const CatalogSnapshot& previous, size_t row, int change) {
+    const ProductColumns* base = previous.columnCache.load(std::memory_order_acquire);
+    // Dictionary codes are positions in `categories`; if those moved, rebuild on next use
+    bool sameDictionary = std::equal(categories.begin(), categories.end(),
+                                     previous.categories.begin(), previous.categories.end(),
+                                     [](const auto& a, const auto& b) { return a.first == b.first; });
+    if (!base || !sameDictionary) return;
+
+    auto* cols = new ProductColumns(*base);
+    if (change < 0) {
+        cols->stock.erase(cols->stock.begin() + row);
+        cols->threshold.erase(cols->threshold.begin() + row);
+        cols->price.erase(cols->price.begin() + row);
+        cols->category.erase(cols->category.begin() + row);
+        cols->status.erase(cols->status.begin() + row);
+    } else {
+        if (change > 0) {
+            cols->stock.insert(cols->stock.begin() + row, 0);
+            cols->threshold.insert(cols->threshold.begin() + row, 0);
+            cols->price.insert(cols->price.begin() + row, 0.0);
+            cols->category.insert(cols->category.begin() + row, 0);
+            cols->status.insert(cols->status.begin() + row, 0);
+        }
+        const Product& p = entries[row]->product;
+        cols->stock[row] = p.stock;
+        cols->threshold[row] = p.threshold;
+        cols->price[row] = p.price;
+        cols->category[row] = categoryCode(categories, p.category);
+        cols->status[row] = static_cast<uint8_t>(p.status);
+    }
+    delete columnCache.exchange(cols, std::memory_order_acq_rel);
+}
+
+const CatalogEntry* CatalogSnapshot::find(std::string_view id) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), id, idLess);
+    return it != entries.end() && (*it)->product.id == id ? *it : nullptr;
+}
+
+namespace Catalog {
+    void rebuild(const std::vector<Product>& products) {
+        auto* next = new CatalogSnapshot;
+        next->entries.reserve(products.size());
+        for (const auto& p : products) {
+            const CatalogEntry* entry = makeEntry(p);
+            next->entries.push_back(entry);
+            next->jsonBytes += entry->json.size();
+            countCategory(next->categories, p.category, 1);
+        }
+        std::sort(next->entries.begin(), next->entries.end(),
+                  [](const CatalogEntry* a, const CatalogEntry* b) { return a->product.id < b->product.id; });
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        const CatalogSnapshot* old = published.load(std::memory_order_relaxed);
+        next->version = old ? old->version + 1 : 1;
+        std::vector<const CatalogEntry*> stale;
+        if (old) stale = old->entries;
+        publish(next);
+
+        // Nothing is shared with the new snapshot; retire only once it is unreachable
+        if (!stale.empty()) {
+            Epoch::retire([stale = std::move(stale)] {
+                for (const CatalogEntry* entry : stale) delete entry;
+            });
+        }
+    }
+
+    void apply(const std::string& id, const std::optional<Product>& row) {
+        apply({{id, row}});
+    }
+
+    void apply(const std::vector<std::pair<std::string, std::optional<Product>>>& rows) {
+        // Change order by id; a later change to the same id wins
+        std::vector<size_t> order(rows.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rows[a].first < rows[b].first; });
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        const CatalogSnapshot* old = published.load(std::memory_order_relaxed);
+        if (!old) return;
+
+        // One merge pass over the old index, however many rows changed
+        auto* next = new CatalogSnapshot;
+        next->version = old->version + 1;
+        next->categories = old->categories;
+        next->jsonBytes = old->jsonBytes;
+        next->entries.reserve(old->entries.size() + rows.size());
+
+        std::vector<const CatalogEntry*> replaced;
+        size_t changed = 0;
+        size_t position = 0;
+        int change = 0;
+        auto from = old->entries.begin();
+        for (size_t k = 0; k < order.size(); ++k) {
+            const auto& [id, row] = rows[order[k]];
+            if (k + 1 < order.size() && rows[order[k + 1]].first == id) continue;
+
+            auto it = std::lower_bound(from, old->entries.end(), std::string_view(id), idLess);
+            next->entries.insert(next->entries.end(), from, it);
+            from = it;
+            const CatalogEntry* previous = it != old->entries.end() && (*it)->product.id == id ? *it : nullptr;
+            if (previous) {
+                ++from;
+                next->jsonBytes -= previous->json.size();
+                countCategory(next->categories, previous->product.category, -1);
+                replaced.push_back(previous);
+            } else if (!row) {
+                continue;
+            }
+
+            position = next->entries.size();
+            if (row) {
+                const CatalogEntry* entry = makeEntry(*row);
+                next->jsonBytes += entry->json.size();
+                countCategory(next->categories, row->category, 1);
+                next->entries.push_back(entry);
+            }
+            change = previous ? (row ? 0 : -1) : 1;
+            ++changed;
+        }
+        next->entries.insert(next->entries.end(), from, old->entries.end());
+
+        if (changed == 0) {
+            delete next;
+            return;
+        }
+
+        // A single-row change patches the previous columns; a larger batch rebuilds them on next use
+        if (changed == 1) next->inheritColumns(*old, position, change);
+        publish(next);
+        if (replaced.size() == 1) {
+            Epoch::retire(replaced.front());
+        } else if (!replaced.empty()) {
+            Epoch::retire([replaced = std::move(replaced)] {
+                for (const CatalogEntry* entry : replaced) delete entry;
+            });
+        }
+    }
+
+    bool loaded() {
+        return published.load(std::memory_order_acquire) != nullptr;
+    }
+
+    const CatalogSnapshot* current() {
+        return published.load(std::memory_order_acquire);
+    }
+
+    std::optional<Product> find(const std::string& id) {
+        Epoch::Guard guard;
+        const CatalogSnapshot* snapshot = current();
+        const CatalogEntry* entry = snapshot ? snapshot->find(id) : nullptr;
+        if (!entry) return std::nullopt;
+        return entry->product;
+    }
+
+    std::vector<Product> products() {
+        Epoch::Guard guard;
+        std::vector<Product> result;
+        const CatalogSnapshot* snapshot = current();
+        if (!snapshot) return result;
+        result.reserve(snapshot->entries.size());
+        for (const CatalogEntry* entry : snapshot->entries) result.push_back(entry->product);
+        return result;
+    }
+
+    std::vector<std::string> categories() {
+        Epoch::Guard guard;
+        std::vector<std::string> result;
+        const CatalogSnapshot* snapshot = current();
+        if (!snapshot) return result;
+        result.reserve(snapshot->categories.size());
+        for (const auto& [name, count] : snapshot->categories) result.push_back(name);
+        return result;
+    }
+
+    bool writeProductListJson(std::string& out) {
+        Epoch::Guard guard;
+        const CatalogSnapshot* snapshot = current();
+        if (!snapshot) return false;
+
+        out.clear();
+        out.reserve(snapshot->jsonBytes + snapshot->entries.size() + 2);
+        out.push_back('[');
+        for (const CatalogEntry* entry : snapshot->entries) {
+            if (out.size() > 1) out.push_back(',');
+            out += entry->json;
+        }
+        out.push_back(']');
+        return true;
+    }
+
+    bool writeFilterJson(const ProductFilter& filter, size_t limit, JsonWriter& out) {
+        Epoch::Guard guard;
+        const CatalogSnapshot* snapshot = current();
+        if (!snapshot) return false;
+
+        const ProductColumns& cols = snapshot->columns();
+        size_t rows = snapshot->entries.size();
+        ColumnFilter::Mask mask = ColumnFilter::all(rows);
+
+        if (filter.minStock || filter.maxStock) {
+            ColumnFilter::between(cols.stock.data(), rows, filter.minStock.value_or(INT32_MIN),
+                                  filter.maxStock.value_or(INT32_MAX), mask);
+        }
+        if (filter.minPrice || filter.maxPrice) {
+            ColumnFilter::between(cols.price.data(), rows, filter.minPrice.value_or(-HUGE_VAL),
+                                  filter.maxPrice.value_or(HUGE_VAL), mask);
+        }
+        if (filter.belowThreshold) {
+            ColumnFilter::less(cols.stock.data(), cols.threshold.data(), rows, mask);
+        }
+        if (filter.category) {
+            uint32_t code = categoryCode(snapshot->categories, *filter.category);
+            if (code == ProductColumns::kNoCategory) mask.assign(mask.size(), 0);
+            else ColumnFilter::equals(cols.category.data(), rows, code, mask);
+        }
+        if (filter.status) {
+            ColumnFilter::equals(cols.status.data(), rows, static_cast<uint8_t>(*filter.status), mask);
+        }
+
+        std::vector<uint32_t> selection;
+        ColumnFilter::select(mask, selection, limit);
+
+        out.beginObject();
+        out.key("total"); out.value(static_cast<uint64_t>(ColumnFilter::count(mask)));
+        out.key("items");
+        out.beginArray();
+        for (uint32_t row : selection) out.raw(snapshot->entries[row]->json);
+        out.endArray();
+        out.endObject();
+        return true;
+    }
+
+    CatalogStats stats() {
+        Epoch::Guard guard;
+        const CatalogSnapshot* snapshot = current();
+        if (!snapshot) return {0, 0, 0, 0};
+        return {snapshot->version, snapshot->entries.size(), snapshot->categories.size(), snapshot->jsonBytes};
+    }
+}
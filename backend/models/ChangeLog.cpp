@@ -0,0 +1,160 @@
+#include "models/ChangeLog.h"
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // Rows deleted per write-queue op, so compaction never holds the writer for long
+    constexpr int64_t kCompactChunk = 10000;
+
+    ChangeLogOptions options;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread compactor;
+    bool running = false;
+
+    std::atomic<uint64_t> compactedCount{0};
+
+    const char* boundsSql = "SELECT max(seq), min(seq) FROM product_changes";
+
+    // latest = highest seq written, oldest = lowest still stored; both 0 when empty
+    bool readBounds(uint64_t& latest, uint64_t& oldest) {
+        auto stmt = Database::prepare(boundsSql);
+        if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) return false;
+        latest = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        oldest = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        return true;
+    }
+
+    void compactorLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            wake.wait_for(lock, options.compactEvery, [] { return !running; });
+            if (!running) break;
+            lock.unlock();
+            size_t dropped = ChangeLog::compact();
+            if (dropped) std::cout << "[ChangeLog] Compacted " << dropped << " entries" << std::endl;
+            Database::release();
+            lock.lock();
+        }
+    }
+}
+
+namespace ChangeLog {
+    void start(const ChangeLogOptions& opts) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        options = opts;
+        running = true;
+        compactor = std::thread(compactorLoop);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        compactor.join();
+    }
+
+    ChangeReadResult read(uint64_t since, size_t limit, std::vector<ProductChange>& out, uint64_t& latest) {
+        sqlite3* db = Database::get();
+        if (!db) return ChangeReadResult::FAILED;
+
+        // One snapshot for the bounds and the rows, so a compaction in between can't open a gap
+        bool ownTransaction = sqlite3_get_autocommit(db);
+        if (ownTransaction && sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            return ChangeReadResult::FAILED;
+        }
+        auto finish = [&](ChangeReadResult result) {
+            if (ownTransaction) sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+            return result;
+        };
+
+        uint64_t oldest = 0;
+        if (!readBounds(latest, oldest)) {
+            std::cerr << "[SQLite] Failed to read change log bounds: " << sqlite3_errmsg(db) << std::endl;
+            return finish(ChangeReadResult::FAILED);
+        }
+        // Entries since+1 .. oldest-1 are gone
+        if (since < latest && since + 1 < oldest) {
+            return finish(ChangeReadResult::COMPACTED);
+        }
+
+        const char* sql = "SELECT seq, op, product_id, changed_at FROM product_changes "
+                          "WHERE seq > ? ORDER BY seq LIMIT ?";
+        auto stmt = Database::prepare(sql);
+        if (!stmt) {
+            std::cerr << "[SQLite] Failed to read change log: " << sqlite3_errmsg(db) << std::endl;
+            return finish(ChangeReadResult::FAILED);
+        }
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(since));
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        auto text = [&](int col) {
+            const unsigned char* v = sqlite3_column_text(stmt, col);
+            return v ? std::string(reinterpret_cast<const char*>(v)) : std::string();
+        };
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            out.push_back(ProductChange{static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)), text(1), text(2), text(3)});
+        }
+        return finish(ChangeReadResult::OK);
+    }
+
+    size_t compact() {
+        // The cutoff is fixed up front, so entries written while compacting are never at risk.
+        // It stays below max(seq): the newest entry is what keeps the next seq from going back.
+        sqlite3* db = Database::get();
+        if (!db) return 0;
+        const char* cutoffSql =
+            "SELECT min(max(coalesce((SELECT seq FROM product_changes WHERE changed_at >= datetime('now', ?1) "
+            "ORDER BY seq LIMIT 1) - 1, max(seq)), max(seq) - ?2), max(seq) - 1) FROM product_changes";
+        int64_t cutoff = 0;
+        {
+            auto stmt = Database::prepare(cutoffSql);
+            if (!stmt) {
+                std::cerr << "[SQLite] Failed to plan change log compaction: " << sqlite3_errmsg(db) << std::endl;
+                return 0;
+            }
+            std::string age = "-" + std::to_string(options.retainFor.count()) + " hours";
+            sqlite3_bind_text(stmt, 1, age.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(options.retainEntries));
+            if (sqlite3_step(stmt) == SQLITE_ROW) cutoff = sqlite3_column_int64(stmt, 0);
+        }
+
+        size_t dropped = 0;
+        while (cutoff > 0) {
+            int deleted = 0;
+            bool ok = WriteQueue::run([&] {
+                const char* sql = "DELETE FROM product_changes "
+                                  "WHERE seq <= min(?1, (SELECT min(seq) FROM product_changes) + ?2 - 1)";
+                auto stmt = Database::prepare(sql);
+                if (!stmt) return false;
+                sqlite3_bind_int64(stmt, 1, cutoff);
+                sqlite3_bind_int64(stmt, 2, kCompactChunk);
+                if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+                deleted = sqlite3_changes(Database::get());
+                return true;
+            });
+            if (!ok) {
+                std::cerr << "[ChangeLog] Compaction failed" << std::endl;
+                break;
+            }
+            if (deleted == 0) break;
+            dropped += static_cast<size_t>(deleted);
+        }
+        compactedCount.fetch_add(dropped, std::memory_order_relaxed);
+        return dropped;
+    }
+
+    ChangeLogStats stats() {
+        uint64_t latest = 0, oldest = 0;
+        readBounds(latest, oldest);
+        return {latest, oldest, compactedCount.load(std::memory_order_relaxed)};
+    }
+}
@@ -0,0 +1,75 @@
+#include "models/ExportCache.h"
+#include "models/ProductExport.h"
+#include "db/DataVersion.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace {
+    const std::filesystem::path directory = "exports";
+
+    std::mutex mutex;
+    ExportArtifact current;
+    std::string previousPath;
+
+    // Older generations and files left by earlier runs. The previous file is kept:
+    // a response handed out just before the switch may not have opened it yet.
+    void sweep() {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            std::string name = entry.path().filename().string();
+            std::string path = entry.path().string();
+            if (name.rfind("products-", 0) != 0 || path == current.path || path == previousPath) continue;
+            // Fails on Windows while the file is being sent; the next sweep retries
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+namespace ExportCache {
+    bool productsCsv(ExportArtifact& out) {
+        // Read before the export's transaction starts, so the file is never older than its generation
+        uint64_t generation = DataVersion::current();
+        std::lock_guard<std::mutex> lock(mutex);
+        std::error_code ec;
+        if (!current.path.empty() && current.generation >= generation && std::filesystem::exists(current.path, ec)) {
+            out = current;
+            return true;
+        }
+
+        std::filesystem::create_directories(directory, ec);
+        std::string path = (directory / ("products-" + std::to_string(generation) + ".csv")).string();
+        std::string temp = path + ".tmp";
+        std::FILE* file = std::fopen(temp.c_str(), "wb");
+        if (!file) {
+            std::cerr << "[ExportCache] Cannot write " << temp << std::endl;
+            return false;
+        }
+        ExportReport report;
+        bool ok = exportProductsCsv(file, report);
+        ok = std::fclose(file) == 0 && ok;
+        if (ok) {
+            std::filesystem::rename(temp, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+
+        if (current.path != path) previousPath = current.path;
+        current = ExportArtifact{path, generation, report.bytes, report.rows};
+        sweep();
+        out = current;
+        return true;
+    }
+
+    bool read(const ExportArtifact& artifact, uint64_t offset, uint64_t length, std::string& out) {
+        std::ifstream file(artifact.path, std::ios::binary);
+        if (!file.seekg(static_cast<std::streamoff>(offset))) return false;
+        out.resize(length);
+        return static_cast<bool>(file.read(out.data(), static_cast<std::streamsize>(length)));
+    }
+}
@@ -0,0 +1,393 @@
+#include "models/HotStock.h"
+#include "models/Product.h"
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    // One cache line each, so threads on different shards never share one
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        int64_t pending = 0;   // net delta accepted since the last flush
+        int64_t budget = 0;    // units this shard may still hand out to picks
+    };
+
+    struct HotProduct {
+        std::string id;
+        int64_t headroom;
+        std::vector<Shard> shards;
+        std::mutex flushMutex;              // one flush or exclusive write at a time
+        bool retired = false;               // written with every shard locked
+        std::atomic<int64_t> flushedStock{0};
+        std::atomic<uint64_t> flushes{0};
+
+        HotProduct(std::string productId, int64_t room, size_t count)
+            : id(std::move(productId)), headroom(room), shards(count) {}
+    };
+
+    // Locks every shard of a product, in index order
+    class AllShards {
+    public:
+        explicit AllShards(HotProduct& p) : product(p) {
+            for (auto& s : product.shards) s.mutex.lock();
+        }
+        ~AllShards() {
+            for (auto it = product.shards.rbegin(); it != product.shards.rend(); ++it) it->mutex.unlock();
+        }
+        AllShards(const AllShards&) = delete;
+        AllShards& operator=(const AllShards&) = delete;
+    private:
+        HotProduct& product;
+    };
+
+    HotStockOptions options;
+    size_t shardCount = 1;
+
+    std::shared_mutex registryMutex;
+    std::unordered_map<std::string, std::shared_ptr<HotProduct>> registry;
+
+    std::mutex loopMutex;
+    std::condition_variable wake;
+    std::thread flusher;
+    bool running = false;
+
+    std::shared_ptr<HotProduct> find(const std::string& id) {
+        std::shared_lock<std::shared_mutex> lock(registryMutex);
+        auto it = registry.find(id);
+        return it == registry.end() ? nullptr : it->second;
+    }
+
+    std::vector<std::shared_ptr<HotProduct>> all() {
+        std::shared_lock<std::shared_mutex> lock(registryMutex);
+        std::vector<std::shared_ptr<HotProduct>> out;
+        out.reserve(registry.size());
+        for (const auto& [id, p] : registry) out.push_back(p);
+        return out;
+    }
+
+    size_t homeShard(size_t count) {
+        static thread_local size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return hash % count;
+    }
+
+    // Caller holds every shard lock
+    int64_t collectPending(HotProduct& p) {
+        int64_t net = 0;
+        for (auto& s : p.shards) {
+            net += s.pending;
+            s.pending = 0;
+        }
+        return net;
+    }
+
+    // Caller holds every shard lock. Picks may take at most the headroom, and never
+    // more than the stock known to exist: what was stored plus what is still pending.
+    void resetBudget(HotProduct& p, int64_t knownStock) {
+        int64_t total = std::max<int64_t>(0, std::min(p.headroom, knownStock));
+        int64_t n = static_cast<int64_t>(p.shards.size());
+        for (int64_t i = 0; i < n; ++i) {
+            p.shards[i].budget = total / n + (i < total % n ? 1 : 0);
+        }
+    }
+
+    bool readStock(const std::string& id, int64_t& stock, bool& found) {
+        auto stmt = Database::prepare("SELECT stock FROM products WHERE id = ?");
+        if (!stmt) return false;
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+        found = sqlite3_step(stmt) == SQLITE_ROW;
+        stock = found ? sqlite3_column_int64(stmt, 0) : 0;
+        return true;
+    }
+
+    // Adds `net` to the stored stock as one ledger movement; `stock` is the value after
+    bool writeNet(const std::string& id, int64_t net, int64_t& stock, bool& found) {
+        if (net == 0) {
+            bool ok = readStock(id, stock, found);
+            Database::release();
+            return ok;
+        }
+        static const std::string sql = "UPDATE products SET stock = stock + ?1, status = " +
+                                       derivedStatusSql("stock + ?1", "threshold") +
+                                       ", updated_at = CURRENT_TIMESTAMP WHERE id = ?2 RETURNING stock";
+        return WriteQueue::run([&] {
+            sqlite3* db = Database::get();
+            {
+                auto stmt = Database::prepare("INSERT INTO stock_movement_context (kind, reference) VALUES (?, 'hot-flush')");
+                if (!stmt) return false;
+                sqlite3_bind_text(stmt, 1, net < 0 ? "pick" : "receive", -1, SQLITE_STATIC);
+                if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+            }
+            auto stmt = Database::prepare(sql);
+            if (!stmt) return false;
+            sqlite3_bind_int64(stmt, 1, net);
+            sqlite3_bind_text(stmt, 2, id.c_str(), -1, SQLITE_STATIC);
+            int rc = sqlite3_step(stmt);
+            found = rc == SQLITE_ROW;
+            if (found) {
+                stock = sqlite3_column_int64(stmt, 0);
+                rc = sqlite3_step(stmt);
+            }
+            if (rc != SQLITE_DONE) {
+                std::cerr << "[HotStock] Failed to flush " << id << ": " << sqlite3_errmsg(db) << std::endl;
+                return false;
+            }
+            if (stock < 0) {
+                std::cerr << "[HotStock] " << id << " oversold to " << stock << " by a write outside the hot path" << std::endl;
+            }
+            auto mark = Database::prepare("UPDATE hot_stock SET flushed_at = CURRENT_TIMESTAMP WHERE product_id = ?");
+            if (!mark) return false;
+            sqlite3_bind_text(mark, 1, id.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(mark) != SQLITE_DONE) return false;
+            return sqlite3_exec(db, "DELETE FROM stock_movement_context;", nullptr, nullptr, nullptr) == SQLITE_OK;
+        });
+    }
+
+    // Caller holds every shard lock
+    void retire(HotProduct& p) {
+        p.retired = true;
+        for (auto& s : p.shards) s.budget = 0;
+        std::unique_lock<std::shared_mutex> lock(registryMutex);
+        auto it = registry.find(p.id);
+        if (it != registry.end() && it->second.get() == &p) registry.erase(it);
+    }
+
+    bool flushProduct(HotProduct& p) {
+        std::lock_guard<std::mutex> serial(p.flushMutex);
+        int64_t net = 0;
+        for (auto& s : p.shards) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            net += s.pending;
+            s.pending = 0;
+        }
+
+        int64_t stock = 0;
+        bool found = false;
+        if (!writeNet(p.id, net, stock, found)) {
+            // Keep the deltas for the next attempt
+            std::lock_guard<std::mutex> lock(p.shards[0].mutex);
+            p.shards[0].pending += net;
+            return false;
+        }
+
+        {
+            AllShards locked(p);
+            if (!found) {
+                retire(p);
+                return true;
+            }
+            // Deltas accepted while the write ran are pending again, and their picks
+            // already came out of the old budget
+            int64_t inFlight = 0;
+            for (const auto& s : p.shards) inFlight += s.pending;
+            resetBudget(p, stock + inFlight);
+        }
+        p.flushedStock.store(stock, std::memory_order_relaxed);
+        p.flushes.fetch_add(1, std::memory_order_relaxed);
+        if (net != 0 && options.onFlushed) options.onFlushed(p.id);
+        return true;
+    }
+
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(loopMutex);
+        while (running) {
+            wake.wait_for(lock, options.flushInterval, [] { return !running; });
+            lock.unlock();
+            for (const auto& p : all()) flushProduct(*p);
+            Database::release();
+            lock.lock();
+        }
+    }
+}
+
+namespace HotStock {
+    void start(const HotStockOptions& opts) {
+        {
+            std::lock_guard<std::mutex> lock(loopMutex);
+            if (running) return;
+            options = opts;
+            shardCount = options.shards ? options.shards : std::max(1u, std::thread::hardware_concurrency());
+            running = true;
+        }
+
+        // Rows left behind by products deleted while hot
+        sqlite3_exec(Database::get(), "DELETE FROM hot_stock WHERE product_id NOT IN (SELECT id FROM products);",
+                     nullptr, nullptr, nullptr);
+        std::vector<std::pair<std::string, int64_t>> saved;
+        if (auto stmt = Database::prepare("SELECT product_id, headroom, flushed_at FROM hot_stock")) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                saved.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), sqlite3_column_int64(stmt, 1));
+                // Without a clean stop, deltas accepted after this point were never written
+                std::cout << "[HotStock] " << saved.back().first << " was hot; stock durable through "
+                          << reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) << std::endl;
+            }
+        }
+        for (const auto& [id, headroom] : saved) promote(id, headroom);
+        Database::release();
+
+        std::lock_guard<std::mutex> lock(loopMutex);
+        flusher = std::thread(flushLoop);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(loopMutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        flusher.join();
+        for (const auto& p : all()) flushProduct(*p);
+        Database::release();
+    }
+
+    bool promote(const std::string& productId, int64_t headroom) {
+        if (headroom <= 0) return false;
+        bool ok = WriteQueue::run([&] {
+            const char* sql = "INSERT INTO hot_stock (product_id, headroom) SELECT id, ?2 FROM products WHERE id = ?1 "
+                              "ON CONFLICT(product_id) DO UPDATE SET headroom = excluded.headroom";
+            auto stmt = Database::prepare(sql);
+            if (!stmt) return false;
+            sqlite3_bind_text(stmt, 1, productId.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 2, headroom);
+            return sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(Database::get()) > 0;
+        });
+        if (!ok) return false;
+
+        std::shared_ptr<HotProduct> p;
+        {
+            // A new product starts with no budget; the flush below reads the stock and hands it out
+            std::unique_lock<std::shared_mutex> lock(registryMutex);
+            auto& slot = registry[productId];
+            if (!slot) slot = std::make_shared<HotProduct>(productId, headroom, shardCount);
+            p = slot;
+        }
+        {
+            std::lock_guard<std::mutex> serial(p->flushMutex);
+            AllShards locked(*p);
+            p->headroom = headroom;
+        }
+        return flushProduct(*p);
+    }
+
+    bool demote(const std::string& productId) {
+        auto p = find(productId);
+        if (!p) return false;
+        // exclusive() holds every shard lock while this runs
+        return exclusive(productId, [&] {
+            bool removed = WriteQueue::run([&] {
+                auto stmt = Database::prepare("DELETE FROM hot_stock WHERE product_id = ?");
+                if (!stmt) return false;
+                sqlite3_bind_text(stmt, 1, productId.c_str(), -1, SQLITE_STATIC);
+                return sqlite3_step(stmt) == SQLITE_DONE;
+            });
+            if (removed) retire(*p);
+            return removed;
+        });
+    }
+
+    HotDeltaResult apply(const std::string& productId, int delta) {
+        auto p = find(productId);
+        if (!p) return HotDeltaResult::NOT_HOT;
+        size_t home = homeShard(p->shards.size());
+
+        if (delta >= 0) {
+            Shard& s = p->shards[home];
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (p->retired) return HotDeltaResult::NOT_HOT;
+            s.pending += delta;
+            return HotDeltaResult::APPLIED;
+        }
+
+        // Own shard first, then borrow from the others one at a time
+        int64_t want = -static_cast<int64_t>(delta);
+        for (size_t k = 0; k < p->shards.size(); ++k) {
+            Shard& s = p->shards[(home + k) % p->shards.size()];
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (p->retired) return HotDeltaResult::NOT_HOT;
+            if (s.budget >= want) {
+                s.budget -= want;
+                s.pending += delta;
+                return HotDeltaResult::APPLIED;
+            }
+        }
+
+        // No single shard has enough; pool them
+        AllShards locked(*p);
+        if (p->retired) return HotDeltaResult::NOT_HOT;
+        int64_t budget = 0, pending = 0;
+        for (const auto& s : p->shards) {
+            budget += s.budget;
+            pending += s.pending;
+        }
+        if (budget < want) {
+            int64_t known = p->flushedStock.load(std::memory_order_relaxed) + pending;
+            return known >= want ? HotDeltaResult::EXHAUSTED : HotDeltaResult::INSUFFICIENT;
+        }
+        for (auto& s : p->shards) {
+            int64_t take = std::min(s.budget, want);
+            s.budget -= take;
+            want -= take;
+        }
+        p->shards[home].pending += delta;
+        return HotDeltaResult::APPLIED;
+    }
+
+    bool flush(const std::string& productId) {
+        auto p = find(productId);
+        return !p || flushProduct(*p);
+    }
+
+    bool exclusive(const std::string& productId, const std::function<bool()>& write) {
+        auto p = find(productId);
+        if (!p) return write();
+
+        std::lock_guard<std::mutex> serial(p->flushMutex);
+        AllShards locked(*p);
+        if (p->retired) return write();
+
+        int64_t net = collectPending(*p);
+        int64_t stock = 0;
+        bool found = false;
+        if (!writeNet(p->id, net, stock, found)) {
+            p->shards[0].pending += net;
+            return false;
+        }
+        bool ok = write();
+        if (!p->retired) {
+            if (!readStock(p->id, stock, found) || !found) {
+                retire(*p);
+            } else {
+                resetBudget(*p, stock);
+                p->flushedStock.store(stock, std::memory_order_relaxed);
+            }
+        }
+        Database::release();
+        if (net != 0 && options.onFlushed) options.onFlushed(p->id);
+        return ok;
+    }
+
+    std::vector<HotProductStats> stats() {
+        std::vector<HotProductStats> out;
+        for (const auto& p : all()) {
+            HotProductStats s{p->id, 0, 0, 0, p->flushedStock.load(std::memory_order_relaxed),
+                              p->flushes.load(std::memory_order_relaxed)};
+            AllShards locked(*p);
+            s.headroom = p->headroom;
+            for (const auto& shard : p->shards) {
+                s.budget += shard.budget;
+                s.pending += shard.pending;
+            }
+            out.push_back(std::move(s));
+        }
+        std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.productId < b.productId; });
+        return out;
+    }
+}
@@ -1,38 +1,57 @@
 #include "models/InventoryModel.h"
 #include "db/Database.h"
+#include "db/DataVersion.h"
+#include "db/WriteQueue.h"
+#include "models/LiveFeed.h"
 #include "models/ProductModel.h"
+#include "utils/JsonWriter.h"
 #include <iostream>
-#include <fstream>
 #include <sstream>
-#include <csv.h> // vcpkg provides this
 #include <sqlite3.h>
 
-std::vector<Product> InventoryModel::fetchInventoryOverview() {
-    std::vector<Product> products;
+bool parseMovementKind(const std::string& s, MovementKind& kind) {
+    if (s == "receive") kind = MovementKind::RECEIVE;
+    else if (s == "pick") kind = MovementKind::PICK;
+    else if (s == "adjust") kind = MovementKind::ADJUST;
+    else if (s == "transfer") kind = MovementKind::TRANSFER;
+    else return false;
+    return true;
+}
+
+const char* movementKindName(MovementKind kind) {
+    switch (kind) {
+        case MovementKind::RECEIVE: return "receive";
+        case MovementKind::PICK: return "pick";
+        case MovementKind::TRANSFER: return "transfer";
+        default: return "adjust";
+    }
+}
+
+void InventoryModel::writeInventoryOverviewJson(JsonWriter& out) {
+    out.beginArray();
     sqlite3* db = Database::get();
-    if (!db) return products;
+    if (!db) {
+        out.endArray();
+        return;
+    }
 
-    const char* sql = "SELECT id, name, description, quantity, price, category, status FROM products;";
-    sqlite3_stmt* stmt;
+    const char* sql = "SELECT id, name, barcode, stock, threshold, status FROM products;";
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    if (auto stmt = Database::prepare(sql)) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
-            Product p;
-            p.id = sqlite3_column_int(stmt, 0);
-            p.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            p.description = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            p.stock = sqlite3_column_int(stmt, 3);
-            p.price = sqlite3_column_double(stmt, 4);
-            p.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-            p.status = parseStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)));
-            products.push_back(p);
+            out.beginObject();
+            out.key("id"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+            out.key("name"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+            out.key("barcode"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
+            out.key("quantity"); out.value(sqlite3_column_int(stmt, 3));
+            out.key("threshold"); out.value(sqlite3_column_int(stmt, 4));
+            out.key("status"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5)));
+            out.endObject();
         }
-        sqlite3_finalize(stmt);
     } else {
-        std::cerr << "[SQLite] Failed to fetch products: " << sqlite3_errmsg(db) << std::endl;
+        std::cerr << "[SQLite] Failed to fetch inventory: " << sqlite3_errmsg(db) << std::endl;
     }
-
-    return products;
+    out.endArray();
 }
 
 std::vector<InventoryAlert> InventoryModel::fetchInventoryAlerts() {
@@ -40,19 +59,24 @@ std::vector<InventoryAlert> InventoryModel::fetchInventoryAlerts() {
     sqlite3* db = Database::get();
     if (!db) return alerts;
 
-    const char* sql = "SELECT id, product_id, message, threshold FROM alerts;";
-    sqlite3_stmt* stmt;
+    const char* sql = "SELECT id, product_id, type, severity, message, created_at FROM alerts "
+                      "ORDER BY created_at DESC, rowid DESC;";
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    if (auto stmt = Database::prepare(sql)) {
+        auto text = [&](int col) {
+            const unsigned char* v = sqlite3_column_text(stmt, col);
+            return v ? std::string(reinterpret_cast<const char*>(v)) : std::string();
+        };
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             InventoryAlert alert;
-            alert.id = sqlite3_column_int(stmt, 0);
-            alert.productId = sqlite3_column_int(stmt, 1);
-            alert.message = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            alert.threshold = sqlite3_column_int(stmt, 3);
+            alert.id = text(0);
+            alert.productId = text(1);
+            alert.type = text(2);
+            alert.severity = text(3);
+            alert.message = text(4);
+            alert.createdAt = text(5);
             alerts.push_back(alert);
         }
-        sqlite3_finalize(stmt);
     } else {
         std::cerr << "[SQLite] Failed to fetch alerts: " << sqlite3_errmsg(db) << std::endl;
     }
@@ -60,111 +84,127 @@ std::vector<InventoryAlert> InventoryModel::fetchInventoryAlerts() {
     return alerts;
 }
 
-bool InventoryModel::deleteInventoryAlert(int alertId) {
+bool InventoryModel::deleteInventoryAlert(const std::string& alertId) {
     sqlite3* db = Database::get();
     if (!db) return false;
 
     const char* sql = "DELETE FROM alerts WHERE id = ?";
-    sqlite3_stmt* stmt;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, alertId);
+    if (auto stmt = Database::prepare(sql)) {
+        sqlite3_bind_text(stmt, 1, alertId.c_str(), -1, SQLITE_STATIC);
         if (sqlite3_step(stmt) == SQLITE_DONE) {
-            sqlite3_finalize(stmt);
+            DataVersion::bump();
+            if (sqlite3_changes(db) > 0) LiveFeed::alertDismissed(alertId);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     std::cerr << "[SQLite] Failed to delete alert: " << sqlite3_errmsg(db) << std::endl;
     return false;
 }
 
-bool InventoryModel::updateStockQuantity(int productId, int newQuantity) {
-    sqlite3* db = Database::get();
-    if (!db) return false;
+StockDeltaResult InventoryModel::updateStockQuantity(const std::string& productId, int newQuantity) {
+    StockDeltaResult result = StockDeltaResult::FAILED;
+    bool ok = WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        if (!db) return false;
 
-    const char* sql = "UPDATE products SET quantity = ? WHERE id = ?";
-    sqlite3_stmt* stmt;
+        static const std::string sql = "UPDATE products SET stock = ?1, status = " + derivedStatusSql("?1", "threshold") +
+                                       ", updated_at = CURRENT_TIMESTAMP WHERE id = ?2";
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, newQuantity);
-        sqlite3_bind_int(stmt, 2, productId);
-        if (sqlite3_step(stmt) == SQLITE_DONE) {
-            sqlite3_finalize(stmt);
-            return true;
+        if (auto stmt = Database::prepare(sql)) {
+            sqlite3_bind_int(stmt, 1, newQuantity);
+            sqlite3_bind_text(stmt, 2, productId.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) == SQLITE_DONE) {
+                result = sqlite3_changes(db) > 0 ? StockDeltaResult::APPLIED : StockDeltaResult::NOT_FOUND;
+                return true;
+            }
         }
-        sqlite3_finalize(stmt);
-    }
 
-    std::cerr << "[SQLite] Failed to update quantity: " << sqlite3_errmsg(db) << std::endl;
-    return false;
-}
+        std::cerr << "[SQLite] Failed to update quantity: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    });
 
-bool InventoryModel::importCSV(const std::string& filePath) {
-    try {
-        io::CSVReader<4> in(filePath); // Adjust number of columns
-        in.read_header(io::ignore_extra_column, "id", "name", "quantity", "status");
+    if (!ok) return StockDeltaResult::FAILED;
+    if (result == StockDeltaResult::APPLIED) refreshProductCaches(productId);
+    return result;
+}
 
+StockDeltaResult InventoryModel::applyStockDelta(const std::string& productId, MovementKind kind, int delta,
+                                                 const std::string& reference, int& newStock) {
+    StockDeltaResult result = StockDeltaResult::FAILED;
+    bool ok = WriteQueue::run([&] {
         sqlite3* db = Database::get();
-        sqlite3_stmt* stmt;
-        const char* insert_sql = "INSERT OR REPLACE INTO products (id, name, quantity, status) VALUES (?, ?, ?, ?)";
-
-        if (sqlite3_prepare_v2(db, insert_sql, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << "Failed to prepare import statement.\n";
-            return false;
+        if (!db) return false;
+
+        // Labels the ledger entry the stock trigger writes for the update below
+        {
+            auto stmt = Database::prepare("INSERT INTO stock_movement_context (kind, reference) VALUES (?, ?)");
+            if (!stmt) return false;
+            sqlite3_bind_text(stmt, 1, movementKindName(kind), -1, SQLITE_STATIC);
+            if (reference.empty()) sqlite3_bind_null(stmt, 2);
+            else sqlite3_bind_text(stmt, 2, reference.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) != SQLITE_DONE) return false;
         }
 
-        int id, quantity;
-        std::string name, status;
-
-        while (in.read_row(id, name, quantity, status)) {
-            sqlite3_bind_int(stmt, 1, id);
-            sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_STATIC);
-            sqlite3_bind_int(stmt, 3, quantity);
-            sqlite3_bind_text(stmt, 4, status.c_str(), -1, SQLITE_STATIC);
-
-            if (sqlite3_step(stmt) != SQLITE_DONE) {
-                std::cerr << "Failed to execute insert during import.\n";
-                sqlite3_finalize(stmt);
+        // Relative to whatever is stored, so concurrent pickers never overwrite each other
+        static const std::string sql = "UPDATE products SET stock = stock + ?1, status = " +
+                                       derivedStatusSql("stock + ?1", "threshold") +
+                                       ", updated_at = CURRENT_TIMESTAMP WHERE id = ?2 AND stock + ?1 >= 0 RETURNING stock";
+        bool applied = false;
+        if (auto stmt = Database::prepare(sql)) {
+            sqlite3_bind_int(stmt, 1, delta);
+            sqlite3_bind_text(stmt, 2, productId.c_str(), -1, SQLITE_STATIC);
+            int rc = sqlite3_step(stmt);
+            if (rc == SQLITE_ROW) {
+                newStock = sqlite3_column_int(stmt, 0);
+                applied = sqlite3_step(stmt) == SQLITE_DONE;
+            } else if (rc != SQLITE_DONE) {
+                std::cerr << "[SQLite] Failed to apply stock delta: " << sqlite3_errmsg(db) << std::endl;
                 return false;
             }
-            sqlite3_reset(stmt);
+        } else {
+            return false;
         }
 
-        sqlite3_finalize(stmt);
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "CSV import error: " << e.what() << '\n';
-        return false;
-    }
-}
-
-bool InventoryModel::exportCSV(const std::string& filePath) {
-    std::ofstream file(filePath);
-    if (!file.is_open()) return false;
-
-    file << "id,name,quantity,status\n";
-
-    sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
-    const char* select_sql = "SELECT id, name, quantity, status FROM products";
+        if (!applied) {
+            // Rolling back the savepoint also drops the context row
+            auto probe = Database::prepare("SELECT 1 FROM products WHERE id = ?");
+            if (!probe) return false;
+            sqlite3_bind_text(probe, 1, productId.c_str(), -1, SQLITE_STATIC);
+            result = sqlite3_step(probe) == SQLITE_ROW ? StockDeltaResult::INSUFFICIENT : StockDeltaResult::NOT_FOUND;
+            return false;
+        }
 
-    if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare export SELECT.\n";
-        return false;
-    }
+        auto clear = Database::prepare("DELETE FROM stock_movement_context");
+        if (!clear || sqlite3_step(clear) != SQLITE_DONE) return false;
+        result = StockDeltaResult::APPLIED;
+        return true;
+    });
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        const unsigned char* name = sqlite3_column_text(stmt, 1);
-        int quantity = sqlite3_column_int(stmt, 2);
-        const unsigned char* status = sqlite3_column_text(stmt, 3);
+    if (result == StockDeltaResult::APPLIED && !ok) result = StockDeltaResult::FAILED;
+    if (result == StockDeltaResult::APPLIED) refreshProductCaches(productId);
+    return result;
+}
 
-        file << id << "," << name << "," << quantity << "," << status << "\n";
+void InventoryModel::writeStockMovementsJson(JsonWriter& out, const std::string& productId, size_t limit) {
+    out.beginArray();
+    const char* sql = "SELECT id, kind, delta, reference, created_at FROM stock_movements "
+                      "WHERE product_id = ? ORDER BY id DESC LIMIT ?";
+    if (auto stmt = Database::prepare(sql)) {
+        sqlite3_bind_text(stmt, 1, productId.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            out.beginObject();
+            out.key("id"); out.value(static_cast<int64_t>(sqlite3_column_int64(stmt, 0)));
+            out.key("kind"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+            out.key("delta"); out.value(sqlite3_column_int(stmt, 2));
+            out.key("reference"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+            out.key("created_at"); out.value(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)));
+            out.endObject();
+        }
+    } else {
+        std::cerr << "[SQLite] Failed to fetch stock movements: " << sqlite3_errmsg(Database::get()) << std::endl;
     }
-
-    sqlite3_finalize(stmt);
-    file.close();
-    return true;
-}
\ No newline at end of file
+    out.endArray();
+}
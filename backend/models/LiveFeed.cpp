@@ -0,0 +1,388 @@
+#include "models/LiveFeed.h"
+#include "db/Database.h"
+#include "models/Catalog.h"
+#include "utils/Epoch.h"
+#include "utils/JsonWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Message = std::shared_ptr<const std::string>;
+
+    // What a write touched, per product. ALERTS is set when the stock level changed;
+    // a plain stock move only touches alerts if the product has an overstock limit.
+    enum : uint8_t { STOCK = 1, PRODUCT = 2, ALERTS = 4 };
+
+    // Past this many distinct changes in one flush it is cheaper for clients to refetch
+    constexpr size_t kMaxChanges = 65536;
+
+    LiveFeedOptions options;
+
+    // Writer side: what changed since the last flush
+    std::mutex changeMutex;
+    std::unordered_map<std::string, uint8_t> changedProducts;
+    std::vector<std::string> dismissedAlerts;
+    bool resyncPending = false;
+    bool dirty = false;
+
+    struct Client {
+        std::function<void(const std::string&)> send;
+        std::function<void()> close;
+        std::vector<std::pair<std::string, Message>> pending;   // in first-changed order
+        std::unordered_map<std::string, size_t> pendingIndex;
+        bool resync = false;
+        bool closing = false;
+        uint64_t sentSeq = 0;
+        uint64_t ackedSeq = 0;
+        std::deque<std::pair<uint64_t, Clock::time_point>> unacked;
+    };
+
+    // Publisher side; also taken by unsubscribe, so no callback runs for a client once it is gone
+    std::mutex clientMutex;
+    std::map<uint64_t, Client> clients;
+    uint64_t nextClientId = 1;
+    std::atomic<size_t> clientCount{0};
+
+    std::condition_variable wake;
+    std::thread publisher;
+    bool running = false;
+
+    std::atomic<uint64_t> eventCount{0};
+    std::atomic<uint64_t> frameCount{0};
+    std::atomic<uint64_t> resyncCount{0};
+    std::atomic<uint64_t> disconnectCount{0};
+
+    // Caller holds changeMutex. Returns whether the publisher needs waking; while it is
+    // already collecting a batch, later writers leave it alone.
+    bool markDirty() {
+        if (changedProducts.size() + dismissedAlerts.size() > kMaxChanges) {
+            changedProducts.clear();
+            dismissedAlerts.clear();
+            resyncPending = true;
+        }
+        bool wasDirty = dirty;
+        dirty = true;
+        return !wasDirty;
+    }
+
+    Message renderProduct(const CatalogSnapshot* snapshot, const std::string& id, uint8_t what) {
+        const CatalogEntry* entry = snapshot ? snapshot->find(id) : nullptr;
+        JsonWriter out;
+        out.beginObject();
+        if (!entry) {
+            out.key("type"); out.value("product-removed");
+            out.key("id"); out.value(id);
+        } else if (what & PRODUCT) {
+            out.key("type"); out.value("product");
+            out.key("product"); out.raw(entry->json);
+        } else {
+            const Product& p = entry->product;
+            out.key("type"); out.value("stock");
+            out.key("id"); out.value(p.id);
+            out.key("stock"); out.value(p.stock);
+            out.key("threshold"); out.value(p.threshold);
+            out.key("status"); out.value(statusToString(p.status));
+        }
+        out.endObject();
+        return std::make_shared<const std::string>(out.take());
+    }
+
+    Message renderAlerts(const std::string& productId) {
+        JsonWriter out;
+        out.beginObject();
+        out.key("type"); out.value("alerts");
+        out.key("product_id"); out.value(productId);
+        out.key("alerts");
+        out.beginArray();
+        const char* sql = "SELECT id, type, severity, message, created_at FROM alerts "
+                          "WHERE product_id = ? ORDER BY created_at DESC, rowid DESC";
+        if (auto stmt = Database::prepare(sql)) {
+            sqlite3_bind_text(stmt, 1, productId.c_str(), -1, SQLITE_STATIC);
+            auto text = [&](int col) { return reinterpret_cast<const char*>(sqlite3_column_text(stmt, col)); };
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                out.beginObject();
+                out.key("id"); out.value(text(0));
+                out.key("type"); out.value(text(1));
+                out.key("severity"); out.value(text(2));
+                out.key("message"); out.value(text(3));
+                out.key("product_id"); out.value(productId);
+                out.key("created_at"); out.value(text(4));
+                out.endObject();
+            }
+        } else {
+            std::cerr << "[LiveFeed] Failed to read alerts: " << sqlite3_errmsg(Database::get()) << std::endl;
+        }
+        out.endArray();
+        out.endObject();
+        return std::make_shared<const std::string>(out.take());
+    }
+
+    // Products with an inventory_settings row, i.e. that can raise overstock alerts
+    std::unordered_set<std::string> overstockTracked() {
+        std::unordered_set<std::string> ids;
+        if (auto stmt = Database::prepare("SELECT product_id FROM inventory_settings")) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                if (auto id = sqlite3_column_text(stmt, 0)) ids.emplace(reinterpret_cast<const char*>(id));
+            }
+        }
+        return ids;
+    }
+
+    Message renderDismissed(const std::string& alertId) {
+        JsonWriter out;
+        out.beginObject();
+        out.key("type"); out.value("alert-dismissed");
+        out.key("id"); out.value(alertId);
+        out.endObject();
+        return std::make_shared<const std::string>(out.take());
+    }
+
+    // Caller holds clientMutex
+    void enqueue(Client& client, const std::string& key, const Message& message) {
+        if (client.resync) return;
+        auto [it, inserted] = client.pendingIndex.try_emplace(key, client.pending.size());
+        if (!inserted) {
+            client.pending[it->second].second = message;
+            return;
+        }
+        client.pending.emplace_back(key, message);
+        if (client.pending.size() > options.maxPending) {
+            client.pending.clear();
+            client.pendingIndex.clear();
+            client.resync = true;
+            resyncCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Caller holds clientMutex. Sends at most one frame if the client has window left.
+    void flush(Client& client, Clock::time_point now) {
+        if (client.closing) return;
+        if (!client.unacked.empty() && now - client.unacked.front().second > options.ackTimeout) {
+            client.closing = true;
+            disconnectCount.fetch_add(1, std::memory_order_relaxed);
+            client.close();
+            return;
+        }
+        if (client.sentSeq - client.ackedSeq >= options.window) return;
+        if (!client.resync && client.pending.empty()) return;
+
+        uint64_t seq = ++client.sentSeq;
+        JsonWriter out;
+        out.beginObject();
+        out.key("seq"); out.value(seq);
+        if (client.resync) {
+            out.key("resync"); out.value(true);
+        } else {
+            out.key("events");
+            out.beginArray();
+            for (const auto& [key, message] : client.pending) out.raw(*message);
+            out.endArray();
+        }
+        out.endObject();
+
+        client.pending.clear();
+        client.pendingIndex.clear();
+        client.resync = false;
+        client.unacked.emplace_back(seq, now);
+        frameCount.fetch_add(1, std::memory_order_relaxed);
+        client.send(out.str());
+    }
+
+    void publish() {
+        std::unordered_map<std::string, uint8_t> products;
+        std::vector<std::string> dismissed;
+        bool resync;
+        {
+            std::lock_guard<std::mutex> lock(changeMutex);
+            products.swap(changedProducts);
+            dismissed.swap(dismissedAlerts);
+            resync = resyncPending;
+            resyncPending = false;
+            dirty = false;
+        }
+
+        // Each change is rendered once and shared by every client
+        std::vector<std::pair<std::string, Message>> rendered;
+        if (!resync) {
+            bool stockMoved = std::any_of(products.begin(), products.end(), [](const auto& c) { return c.second & STOCK; });
+            std::unordered_set<std::string> tracked;
+            if (stockMoved) tracked = overstockTracked();
+
+            Epoch::Guard guard;
+            const CatalogSnapshot* snapshot = Catalog::current();
+            for (const auto& [id, what] : products) {
+                rendered.emplace_back("p:" + id, renderProduct(snapshot, id, what));
+                if ((what & ALERTS) || ((what & STOCK) && tracked.count(id))) rendered.emplace_back("a:" + id, renderAlerts(id));
+            }
+            for (const auto& alertId : dismissed) rendered.emplace_back("d:" + alertId, renderDismissed(alertId));
+            Database::release();
+        }
+
+        std::lock_guard<std::mutex> lock(clientMutex);
+        auto now = Clock::now();
+        for (auto& [id, client] : clients) {
+            if (resync && !client.resync) {
+                client.pending.clear();
+                client.pendingIndex.clear();
+                client.resync = true;
+            }
+            for (const auto& [key, message] : rendered) enqueue(client, key, message);
+            flush(client, now);
+        }
+    }
+
+    void publisherLoop() {
+        std::unique_lock<std::mutex> lock(changeMutex);
+        while (running) {
+            // Idle clients still need their ack deadlines checked now and then
+            wake.wait_for(lock, std::chrono::seconds(1), [] { return dirty || !running; });
+            if (!running) break;
+
+            if (dirty) {
+                // Batch window: let a burst of writes land in the same frame
+                wake.wait_for(lock, options.flushInterval, [] { return !running; });
+            }
+            lock.unlock();
+            publish();
+            lock.lock();
+        }
+    }
+}
+
+namespace LiveFeed {
+    void start(const LiveFeedOptions& opts) {
+        std::lock_guard<std::mutex> lock(changeMutex);
+        if (running) return;
+        options = opts;
+        if (options.window == 0) options.window = 1;
+        running = true;
+        publisher = std::thread(publisherLoop);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(changeMutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        publisher.join();
+    }
+
+    void productWritten(const std::string& id, const std::optional<Product>& row) {
+        if (clientCount.load(std::memory_order_relaxed) == 0) return;
+
+        uint8_t what = 0;
+        {
+            Epoch::Guard guard;
+            const CatalogSnapshot* snapshot = Catalog::current();
+            const CatalogEntry* entry = snapshot ? snapshot->find(id) : nullptr;
+            if (!entry || !row) {
+                what = (entry || row) ? PRODUCT | ALERTS : 0;
+            } else {
+                const Product& before = entry->product;
+                bool stockMoved = before.stock != row->stock || before.threshold != row->threshold;
+                bool otherMoved = before.name != row->name || before.sku != row->sku ||
+                                  before.category != row->category || before.description != row->description ||
+                                  before.barcode != row->barcode || before.price != row->price;
+                if (stockMoved) what |= STOCK;
+                if (deriveStatus(before.stock, before.threshold) != deriveStatus(row->stock, row->threshold)) what |= ALERTS;
+                if (otherMoved) what |= PRODUCT;
+            }
+        }
+        if (!what) return;
+
+        eventCount.fetch_add(1, std::memory_order_relaxed);
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(changeMutex);
+            changedProducts[id] |= what;
+            notify = markDirty();
+        }
+        if (notify) wake.notify_one();
+    }
+
+    void alertDismissed(const std::string& alertId) {
+        if (clientCount.load(std::memory_order_relaxed) == 0) return;
+        eventCount.fetch_add(1, std::memory_order_relaxed);
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(changeMutex);
+            dismissedAlerts.push_back(alertId);
+            notify = markDirty();
+        }
+        if (notify) wake.notify_one();
+    }
+
+    void resyncAll() {
+        if (clientCount.load(std::memory_order_relaxed) == 0) return;
+        eventCount.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(changeMutex);
+            changedProducts.clear();
+            dismissedAlerts.clear();
+            resyncPending = true;
+            dirty = true;
+        }
+        wake.notify_one();
+    }
+
+    uint64_t subscribe(std::function<void(const std::string&)> send, std::function<void()> close) {
+        std::lock_guard<std::mutex> lock(clientMutex);
+        uint64_t id = nextClientId++;
+        Client& client = clients[id];
+        client.send = std::move(send);
+        client.close = std::move(close);
+        clientCount.store(clients.size(), std::memory_order_relaxed);
+        return id;
+    }
+
+    void unsubscribe(uint64_t client) {
+        std::lock_guard<std::mutex> lock(clientMutex);
+        clients.erase(client);
+        clientCount.store(clients.size(), std::memory_order_relaxed);
+    }
+
+    void acknowledge(uint64_t clientId, uint64_t seq) {
+        bool backlog = false;
+        {
+            std::lock_guard<std::mutex> lock(clientMutex);
+            auto it = clients.find(clientId);
+            if (it == clients.end()) return;
+            Client& client = it->second;
+            if (seq <= client.ackedSeq || seq > client.sentSeq) return;
+            client.ackedSeq = seq;
+            while (!client.unacked.empty() && client.unacked.front().first <= seq) client.unacked.pop_front();
+            backlog = client.resync || !client.pending.empty();
+        }
+        // The window reopened with changes waiting: let the publisher send them
+        if (backlog) {
+            {
+                std::lock_guard<std::mutex> lock(changeMutex);
+                dirty = true;
+            }
+            wake.notify_one();
+        }
+    }
+
+    LiveFeedStats stats() {
+        return {
+            clientCount.load(std::memory_order_relaxed),
+            eventCount.load(std::memory_order_relaxed),
+            frameCount.load(std::memory_order_relaxed),
+            resyncCount.load(std::memory_order_relaxed),
+            disconnectCount.load(std::memory_order_relaxed)
+        };
+    }
+}
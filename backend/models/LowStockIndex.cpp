@@ -0,0 +1,74 @@
+#include "models/LowStockIndex.h"
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+    using Key = std::pair<double, std::string>;     // (ratio, id); id breaks ties deterministically
+
+    std::shared_mutex mutex;
+    std::set<Key> ordered;
+    std::unordered_map<std::string, double> ratioById;
+
+    std::optional<double> ratioOf(const Product& p) {
+        if (p.threshold > 0) return static_cast<double>(p.stock) / p.threshold;
+        if (p.stock <= 0) return 0.0;
+        return std::nullopt;
+    }
+
+    // Caller holds the lock exclusively
+    void eraseLocked(const std::string& id) {
+        auto it = ratioById.find(id);
+        if (it == ratioById.end()) return;
+        ordered.erase(Key{it->second, id});
+        ratioById.erase(it);
+    }
+}
+
+namespace LowStockIndex {
+    void rebuild(const std::vector<Product>& products) {
+        std::set<Key> freshOrder;
+        std::unordered_map<std::string, double> freshRatios;
+        freshRatios.reserve(products.size());
+        for (const auto& p : products) {
+            if (auto ratio = ratioOf(p)) {
+                freshOrder.emplace(*ratio, p.id);
+                freshRatios.emplace(p.id, *ratio);
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        ordered.swap(freshOrder);
+        ratioById.swap(freshRatios);
+    }
+
+    void apply(const std::string& id, const std::optional<Product>& row) {
+        std::optional<double> ratio = row ? ratioOf(*row) : std::nullopt;
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ratioById.find(id);
+        if (it != ratioById.end() && ratio && it->second == *ratio) return;
+        eraseLocked(id);
+        if (ratio) {
+            ordered.emplace(*ratio, id);
+            ratioById.emplace(id, *ratio);
+        }
+    }
+
+    std::vector<LowStockItem> top(size_t limit, double maxRatio) {
+        std::vector<LowStockItem> items;
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        for (auto it = ordered.begin(); it != ordered.end() && items.size() < limit; ++it) {
+            if (it->first > maxRatio) break;
+            items.push_back({it->second, it->first});
+        }
+        return items;
+    }
+
+    size_t size() {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return ordered.size();
+    }
+}
@@ -0,0 +1,28 @@
+#include "models/Product.h"
+#include "utils/JsonWriter.h"
+
+void writeProductJson(JsonWriter& out, const Product& p) {
+    out.beginObject();
+    out.key("id"); out.value(p.id);
+    out.key("name"); out.value(p.name);
+    out.key("sku"); out.value(p.sku);
+    out.key("barcode"); out.value(p.barcode);
+    out.key("category"); out.value(p.category);
+    out.key("description"); out.value(p.description);
+    out.key("stock"); out.value(p.stock);
+    out.key("threshold"); out.value(p.threshold);
+    out.key("price"); out.value(p.price);
+    out.key("status"); out.value(statusToString(p.status));
+    out.endObject();
+}
+
+std::string encodeProductJson(const Product& p) {
+    JsonWriter out(256);
+    writeProductJson(out, p);
+    return out.take();
+}
+
+std::string derivedStatusSql(const std::string& stock, const std::string& threshold) {
+    return "CASE WHEN " + stock + " <= 0 THEN 'out-of-stock' WHEN " + stock + " <= " + threshold +
+           " THEN 'low-stock' ELSE 'in-stock' END";
+}
@@ -0,0 +1,58 @@
+#include "models/ProductExport.h"
+#include "db/Database.h"
+#include "utils/CsvWriter.h"
+#include <chrono>
+#include <iostream>
+#include <string_view>
+
+namespace {
+    bool exec(sqlite3* db, const char* sql) {
+        if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK) return true;
+        std::cerr << "[ProductExport] " << sql << " failed: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    std::string_view text(sqlite3_stmt* stmt, int col) {
+        auto value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return value ? std::string_view(value, static_cast<size_t>(sqlite3_column_bytes(stmt, col))) : std::string_view();
+    }
+}
+
+bool exportProductsCsv(std::FILE* out, ExportReport& report) {
+    auto start = std::chrono::steady_clock::now();
+    report = ExportReport{};
+    sqlite3* db = Database::get();
+    if (!db) return false;
+
+    bool ownTransaction = sqlite3_get_autocommit(db);
+    if (ownTransaction && !exec(db, "BEGIN;")) return false;
+
+    bool ok = false;
+    {
+        auto stmt = Database::prepare(
+            "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products");
+        if (!stmt) {
+            std::cerr << "Export Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+        } else {
+            CsvWriter csv(out);
+            csv.raw("id,name,sku,barcode,category,stock,threshold,price,status\n");
+            int rc;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                for (int col = 0; col < 5; ++col) csv.value(text(stmt, col));
+                csv.value(static_cast<int64_t>(sqlite3_column_int64(stmt, 5)));
+                csv.value(static_cast<int64_t>(sqlite3_column_int64(stmt, 6)));
+                csv.value(sqlite3_column_double(stmt, 7));
+                csv.value(text(stmt, 8));
+                csv.endRow();
+                ++report.rows;
+            }
+            if (rc != SQLITE_DONE) std::cerr << "Export Step Failed: " << sqlite3_errmsg(db) << "\n";
+            ok = csv.flush() && rc == SQLITE_DONE;
+            report.bytes = csv.bytes();
+        }
+    }
+    if (ownTransaction) exec(db, "COMMIT;");
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
@@ -0,0 +1,265 @@
+#include "models/ProductImport.h"
+#include "models/Product.h"
+#include "models/ProductModel.h"
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include "utils/CsvReader.h"
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace {
+    enum Column { ID, NAME, SKU, BARCODE, CATEGORY, STOCK, THRESHOLD, PRICE, COLUMN_COUNT };
+    const char* const kColumnNames[COLUMN_COUNT] = {"id", "name", "sku", "barcode", "category", "stock", "threshold", "price"};
+
+    // Where each column sits in the file's rows
+    struct Layout {
+        size_t position[COLUMN_COUNT];
+        size_t minFields;
+    };
+
+    struct ImportRow {
+        Product product;
+        unsigned line;    // within its chunk until the writer rebases it
+    };
+
+    struct ParsedChunk {
+        std::vector<ImportRow> rows;
+        std::vector<std::pair<unsigned, std::string>> errors;
+        unsigned lines = 0;
+        size_t rowsRead = 0;
+    };
+
+    std::string newProductId() {
+        static thread_local boost::uuids::random_generator generator;
+        return boost::uuids::to_string(generator());
+    }
+
+    bool parseHeader(const std::vector<std::string_view>& fields, Layout& layout, std::string& error) {
+        layout.minFields = 0;
+        for (int c = 0; c < COLUMN_COUNT; ++c) {
+            auto it = std::find(fields.begin(), fields.end(), kColumnNames[c]);
+            if (it == fields.end()) {
+                error = std::string("Missing column '") + kColumnNames[c] + "'";
+                return false;
+            }
+            layout.position[c] = static_cast<size_t>(it - fields.begin());
+            layout.minFields = std::max(layout.minFields, layout.position[c] + 1);
+        }
+        return true;
+    }
+
+    // from_chars also takes "nan" and "inf" for doubles; a price must be finite
+    template <typename T>
+    bool parseNumber(std::string_view v, T& out) {
+        if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+        auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+        bool ok = ec == std::errc() && end == v.data() + v.size() && !v.empty();
+        if constexpr (std::is_floating_point_v<T>) ok = ok && std::isfinite(out);
+        return ok;
+    }
+
+    // Parses and validates every record of one chunk; runs on a parser thread
+    void parseChunk(std::string_view chunk, const Layout& layout, ParsedChunk& out) {
+        CsvReader reader(chunk);
+        std::vector<std::string_view> fields;
+        while (reader.next(fields)) {
+            unsigned lineNo = reader.line();
+            if (fields.size() == 1 && fields[0].empty()) continue;
+            ++out.rowsRead;
+
+            if (reader.unterminated()) {
+                out.errors.emplace_back(lineNo, "Unterminated quoted field");
+                continue;
+            }
+            if (fields.size() < layout.minFields) {
+                out.errors.emplace_back(lineNo, "Too few columns");
+                continue;
+            }
+            auto field = [&](Column c) { return fields[layout.position[c]]; };
+
+            ImportRow row{};
+            Product& p = row.product;
+            if (!parseNumber(field(STOCK), p.stock) || !parseNumber(field(THRESHOLD), p.threshold) ||
+                !parseNumber(field(PRICE), p.price)) {
+                out.errors.emplace_back(lineNo, "Invalid number in stock, threshold or price");
+                continue;
+            }
+            if (field(NAME).empty() || field(SKU).empty()) {
+                out.errors.emplace_back(lineNo, "'name' and 'sku' must not be empty");
+                continue;
+            }
+            p.id = field(ID).empty() ? newProductId() : std::string(field(ID));
+            p.name = field(NAME);
+            p.sku = field(SKU);
+            p.barcode = field(BARCODE);
+            p.category = field(CATEGORY);
+            p.status = deriveStatus(p.stock, p.threshold);
+            row.line = lineNo;
+            out.rows.push_back(std::move(row));
+        }
+        out.lines = reader.lines();
+    }
+
+    // Record-aligned slices of about `target` bytes
+    std::vector<std::string_view> splitChunks(std::string_view body, size_t target) {
+        std::vector<std::string_view> chunks;
+        size_t start = 0;
+        while (start < body.size()) {
+            size_t end = CsvReader::recordBoundary(body, start, target);
+            chunks.push_back(body.substr(start, end - start));
+            start = end;
+        }
+        return chunks;
+    }
+
+    // Parsed chunks handed to the writer in file order. A parser blocks once its
+    // chunk is `capacity` or more ahead of the writer, which bounds memory.
+    class ChunkQueue {
+    public:
+        explicit ChunkQueue(size_t capacity) : capacity(capacity) {}
+
+        void push(size_t index, ParsedChunk&& chunk) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return index < nextOut + capacity; });
+            ready.emplace(index, std::move(chunk));
+            changed.notify_all();
+        }
+
+        ParsedChunk pop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return ready.count(nextOut) > 0; });
+            auto node = ready.extract(nextOut++);
+            changed.notify_all();
+            return std::move(node.mapped());
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::map<size_t, ParsedChunk> ready;
+        size_t nextOut = 0;
+        size_t capacity;
+    };
+
+    void addError(ImportReport& report, const ImportOptions& options, unsigned line, const std::string& reason) {
+        ++report.failed;
+        if (report.errors.size() < options.maxErrors) {
+            report.errors.push_back("line " + std::to_string(line) + ": " + reason);
+        }
+    }
+
+    void writeBatch(const std::vector<ImportRow>& batch, ImportReport& report, const ImportOptions& options,
+                    std::vector<std::string>& written) {
+        size_t before = written.size();
+        std::vector<std::pair<unsigned, std::string>> rejected;
+        bool committed = WriteQueue::run([&] {
+            written.resize(before);
+            rejected.clear();
+            sqlite3* db = Database::get();
+            const char* sql = "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+            auto stmt = Database::prepare(sql);
+            if (!stmt) {
+                std::cerr << "Import Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+                return false;
+            }
+            for (const auto& row : batch) {
+                const Product& p = row.product;
+                sqlite3_bind_text(stmt, 1, p.id.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 2, p.name.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 3, p.sku.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 4, p.barcode.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 5, p.category.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int(stmt, 6, p.stock);
+                sqlite3_bind_int(stmt, 7, p.threshold);
+                sqlite3_bind_double(stmt, 8, p.price);
+                sqlite3_bind_text(stmt, 9, statusToString(p.status).c_str(), -1, SQLITE_TRANSIENT);
+                if (sqlite3_step(stmt) == SQLITE_DONE) written.push_back(p.id);
+                else rejected.emplace_back(row.line, sqlite3_errmsg(db));
+                sqlite3_reset(stmt);
+            }
+            return true;
+        });
+
+        if (!committed) {
+            written.resize(before);
+            for (const auto& row : batch) addError(report, options, row.line, "Transaction failed");
+            return;
+        }
+        report.imported += written.size() - before;
+        for (const auto& [line, reason] : rejected) addError(report, options, line, reason);
+    }
+}
+
+ImportReport importProductsCsv(std::string_view csv, const ImportOptions& options) {
+    ImportReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    CsvReader headerReader(csv);
+    std::vector<std::string_view> header;
+    headerReader.next(header);
+    Layout layout{};
+    if (!parseHeader(header, layout, report.headerError)) return report;
+    std::string_view body = csv.substr(headerReader.offset());
+
+    std::vector<std::string_view> chunks = splitChunks(body, options.chunkBytes);
+    // One core is left for the writer
+    unsigned cores = std::thread::hardware_concurrency();
+    size_t threads = options.parserThreads ? options.parserThreads : (cores > 1 ? cores - 1 : 1);
+    threads = std::max<size_t>(1, std::min(threads, chunks.size()));
+
+    // Parsers take chunks in order; this thread is the single writer
+    ChunkQueue queue(std::max<size_t>(options.queueChunks, threads));
+    std::atomic<size_t> nextChunk{0};
+    std::vector<std::thread> parsers;
+    for (size_t t = 0; t < threads; ++t) {
+        parsers.emplace_back([&] {
+            for (size_t i; (i = nextChunk.fetch_add(1)) < chunks.size();) {
+                ParsedChunk parsed;
+                parseChunk(chunks[i], layout, parsed);
+                queue.push(i, std::move(parsed));
+            }
+        });
+    }
+
+    std::vector<std::string> written;
+    std::vector<ImportRow> batch;
+    batch.reserve(options.batchRows);
+    unsigned lineBase = headerReader.lines();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        ParsedChunk parsed = queue.pop();
+        report.rows += parsed.rowsRead;
+        for (const auto& [line, reason] : parsed.errors) addError(report, options, lineBase + line, reason);
+        for (auto& row : parsed.rows) {
+            row.line += lineBase;
+            batch.push_back(std::move(row));
+            if (batch.size() >= options.batchRows) {
+                if (options.dryRun) report.imported += batch.size();
+                else writeBatch(batch, report, options, written);
+                batch.clear();
+            }
+        }
+        lineBase += parsed.lines;
+    }
+    if (!batch.empty()) {
+        if (options.dryRun) report.imported += batch.size();
+        else writeBatch(batch, report, options, written);
+    }
+    for (auto& t : parsers) t.join();
+
+    refreshProductCaches(written);
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
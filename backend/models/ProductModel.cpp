@@ -1,20 +1,23 @@
 #include "models/ProductModel.h"
+#include "models/BarcodeIndex.h"
+#include "models/Catalog.h"
+#include "models/LiveFeed.h"
+#include "models/LowStockIndex.h"
 #include "db/Database.h"
+#include "db/DataVersion.h"
+#include "db/Schema.h"
+#include "db/WriteQueue.h"
+#include "utils/JsonWriter.h"
 #include <sqlite3.h>
 #include <iostream>
+#include <charconv>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
-std::string statusToString(ProductStatus status) {
-    switch (status) {
-        case ProductStatus::IN_STOCK: return "in-stock";
-        case ProductStatus::LOW_STOCK: return "low-stock";
-        case ProductStatus::OUT_OF_STOCK: return "out-of-stock";
-        default: return "unknown";
-    }
-}
-
 ProductStatus stringToStatus(const std::string& statusStr) {
     return parseStatus(statusStr);
 }
@@ -26,6 +29,26 @@ static std::string generateUUID() {
     return boost::uuids::to_string(uuid);
 }
 
+// Reads a row selected as: id, name, sku, barcode, category, stock, threshold, price, status
+static Product productFromRow(sqlite3_stmt* stmt) {
+    auto text = [stmt](int col) {
+        auto value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return value ? std::string(value) : std::string();
+    };
+
+    Product p;
+    p.id = text(0);
+    p.name = text(1);
+    p.sku = text(2);
+    p.barcode = text(3);
+    p.category = text(4);
+    p.stock = sqlite3_column_int(stmt, 5);
+    p.threshold = sqlite3_column_int(stmt, 6);
+    p.price = sqlite3_column_double(stmt, 7);
+    p.status = stringToStatus(text(8));
+    return p;
+}
+
 bool insertProduct(
     const std::string& id,
     const std::string& name,
@@ -34,73 +57,65 @@ bool insertProduct(
     const std::string& category,
     int stock,
     int threshold,
-    double price,
-    ProductStatus status
+    double price
 ) {
-    sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
-    std::string sql = "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
-                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    bool ok = WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        std::string sql = "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                          "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+        auto stmt = Database::prepare(sql);
+        if (!stmt) {
+            std::cerr << "Insert Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+            return false;
+        }
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Insert Prepare Failed: " << sqlite3_errmsg(db) << "\n";
-        return false;
-    }
+        std::string statusStr = statusToString(deriveStatus(stock, threshold));
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, sku.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, barcode.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 5, category.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 6, stock);
+        sqlite3_bind_int(stmt, 7, threshold);
+        sqlite3_bind_double(stmt, 8, price);
+        sqlite3_bind_text(stmt, 9, statusStr.c_str(), -1, SQLITE_STATIC);
+
+        bool success = sqlite3_step(stmt) == SQLITE_DONE;
+        if (!success) {
+            std::cerr << "Insert Failed: " << sqlite3_errmsg(db) << "\n";
+        }
+        return success;
+    });
 
-    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, sku.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, barcode.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 5, category.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 6, stock);
-    sqlite3_bind_int(stmt, 7, threshold);
-    sqlite3_bind_double(stmt, 8, price);
-    sqlite3_bind_text(stmt, 9, statusToString(status).c_str(), -1, SQLITE_STATIC);
-
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (!success) {
-        std::cerr << "Insert Failed: " << sqlite3_errmsg(db) << "\n";
-    }
-    sqlite3_finalize(stmt);
-    return success;
+    if (ok) refreshProductCaches(id);
+    return ok;
 }
 
 std::vector<Product> getAllProductsFromDB() {
     sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
     std::vector<Product> products;
     std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products";
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
         std::cerr << "Select Prepare Failed: " << sqlite3_errmsg(db) << "\n";
         return products;
     }
 
     while(sqlite3_step(stmt) == SQLITE_ROW) {
-        Product p;
-        p.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        p.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        p.sku = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        p.barcode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        p.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        p.stock = sqlite3_column_int(stmt, 5);
-        p.threshold = sqlite3_column_int(stmt, 6);
-        p.price = sqlite3_column_double(stmt, 7);
-        p.status = stringToStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8)));
-
-        products.push_back(p);
+        products.push_back(productFromRow(stmt));
     }
 
-    sqlite3_finalize(stmt);
     return products;
 }
 
 std::optional<Product> getProductByIdFromDB(const std::string& id) {
     sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
     std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products WHERE id = ?";
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
         std::cerr << "Select By ID Prepare Failed: " << sqlite3_errmsg(db) << "\n";
         return std::nullopt;
     }
@@ -108,31 +123,18 @@ std::optional<Product> getProductByIdFromDB(const std::string& id) {
     sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
 
     if(sqlite3_step(stmt) == SQLITE_ROW) {
-        Product p;
-        p.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        p.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        p.sku = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        p.barcode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        p.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        p.stock = sqlite3_column_int(stmt, 5);
-        p.threshold = sqlite3_column_int(stmt, 6);
-        p.price = sqlite3_column_double(stmt, 7);
-        p.status = stringToStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8)));
-
-        sqlite3_finalize(stmt);
-        return p;
+        return productFromRow(stmt);
     }
 
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
 std::optional<Product> getProductByBarcode(const std::string& barcode) {
     sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
     std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products WHERE barcode = ?";
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
         std::cerr << "Select By Barcode Prepare Failed: " << sqlite3_errmsg(db) << "\n";
         return std::nullopt;
     }
@@ -140,59 +142,261 @@ std::optional<Product> getProductByBarcode(const std::string& barcode) {
     sqlite3_bind_text(stmt, 1, barcode.c_str(), -1, SQLITE_STATIC);
 
     if(sqlite3_step(stmt) == SQLITE_ROW) {
-        Product p;
-        p.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        p.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        p.sku = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        p.barcode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        p.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        p.stock = sqlite3_column_int(stmt, 5);
-        p.threshold = sqlite3_column_int(stmt, 6);
-        p.price = sqlite3_column_double(stmt, 7);
-        p.status = stringToStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8)));
-
-        sqlite3_finalize(stmt);
-        return p;
+        return productFromRow(stmt);
     }
 
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
-std::vector<Product> searchProducts(const std::string& query) {
+// Caps the unpaged search response, which the products page requests on every keystroke
+static const int kSearchResultLimit = 200;
+
+// Turns user input into an FTS5 prefix query: `red shi` -> `"red"* "shi"*`
+static std::string toFtsQuery(const std::string& input) {
+    std::string out, token;
+    auto flush = [&] {
+        if (token.empty()) return;
+        if (!out.empty()) out += ' ';
+        out += '"' + token + "\"*";
+        token.clear();
+    };
+    for (char c : input) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') flush();
+        else if (c != '"') token += c;
+    }
+    flush();
+    return out;
+}
+
+static std::string idCursor(sqlite3_stmt* stmt) {
+    return reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+}
+
+// FTS results are ordered by (rank, rowid); columns 9 and 10 carry both
+static std::string rankCursor(sqlite3_stmt* stmt) {
+    char buf[64];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), sqlite3_column_double(stmt, 9));
+    *end++ = ':';
+    end = std::to_chars(end, buf + sizeof(buf), sqlite3_column_int64(stmt, 10)).ptr;
+    return std::string(buf, end);
+}
+
+// Search statement bound and ready to step. Rows come back in productFromRow order;
+// `after` is a cursor produced by searchCursor() for the same query ("" = from the top).
+static Statement prepareSearch(const std::string& query, const std::string& after, int limit) {
     sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
-    std::vector<Product> products;
-    std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products WHERE name LIKE ? OR category LIKE ?";
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    if (!Schema::hasFullTextSearch()) {
+        std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products "
+                          "WHERE (name LIKE ? OR category LIKE ?) AND id > ? ORDER BY id LIMIT ?";
+        auto stmt = Database::prepare(sql);
+        if (!stmt) {
+            std::cerr << "Search Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+            return {};
+        }
+        std::string pattern = "%" + query + "%";
+        sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, pattern.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, after.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 4, limit);
+        return stmt;
+    }
+
+    std::string match = toFtsQuery(query);
+    if (match.empty()) return {};
+
+    // BM25-ranked prefix match; the weights live in the table's rank config (db/Schema.cpp).
+    // Only the winning page of rowids is joined back to products.
+    std::string sql = "WITH hits AS (SELECT rowid, rank FROM products_fts WHERE products_fts MATCH ?1 "
+                      "AND (?2 IS NULL OR rank > ?2 OR (rank = ?2 AND rowid > ?3)) ORDER BY rank, rowid LIMIT ?4) "
+                      "SELECT p.id, p.name, p.sku, p.barcode, p.category, p.stock, p.threshold, p.price, p.status, "
+                      "hits.rank, hits.rowid FROM hits JOIN products p ON p.rowid = hits.rowid "
+                      "ORDER BY hits.rank, hits.rowid";
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
         std::cerr << "Search Prepare Failed: " << sqlite3_errmsg(db) << "\n";
-        return products;
+        return {};
     }
 
-    std::string pattern = "%" + query + "%";
-    sqlite3_bind_text(stmt, 1, pattern.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, pattern.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    auto sep = after.rfind(':');
+    if (sep != std::string::npos) {
+        double rank = 0;
+        sqlite3_int64 rowid = 0;
+        std::from_chars(after.data(), after.data() + sep, rank);
+        std::from_chars(after.data() + sep + 1, after.data() + after.size(), rowid);
+        sqlite3_bind_double(stmt, 2, rank);
+        sqlite3_bind_int64(stmt, 3, rowid);
+    }
+    sqlite3_bind_int(stmt, 4, limit);
+    return stmt;
+}
+
+static std::string searchCursor(sqlite3_stmt* stmt) {
+    return Schema::hasFullTextSearch() ? rankCursor(stmt) : idCursor(stmt);
+}
+
+std::vector<Product> searchProducts(const std::string& query) {
+    std::vector<Product> products;
+    auto stmt = prepareSearch(query, "", kSearchResultLimit);
+    if (!stmt) {
+        return products;
+    }
 
     while(sqlite3_step(stmt) == SQLITE_ROW) {
-        Product p;
-        p.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        p.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        p.sku = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        p.barcode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        p.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        p.stock = sqlite3_column_int(stmt, 5);
-        p.threshold = sqlite3_column_int(stmt, 6);
-        p.price = sqlite3_column_double(stmt, 7);
-        p.status = stringToStatus(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8)));
-
-        products.push_back(p);
+        products.push_back(productFromRow(stmt));
     }
 
-    sqlite3_finalize(stmt);
     return products;
 }
 
+// Encodes the current row (same column order as productFromRow) as a productToJson-shaped object
+static void writeProductRow(JsonWriter& out, sqlite3_stmt* stmt) {
+    auto text = [stmt](int col) {
+        auto value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return value ? std::string_view(value, sqlite3_column_bytes(stmt, col)) : std::string_view();
+    };
+
+    out.beginObject();
+    out.key("id"); out.value(text(0));
+    out.key("name"); out.value(text(1));
+    out.key("sku"); out.value(text(2));
+    out.key("barcode"); out.value(text(3));
+    out.key("category"); out.value(text(4));
+    out.key("description"); out.value("");
+    out.key("stock"); out.value(sqlite3_column_int(stmt, 5));
+    out.key("threshold"); out.value(sqlite3_column_int(stmt, 6));
+    out.key("price"); out.value(sqlite3_column_double(stmt, 7));
+    out.key("status"); out.value(statusToString(parseStatus(std::string(text(8)))));
+    out.endObject();
+}
+
+// Writes rows as a JSON array. With limit >= 0 the statement must have been bound
+// with LIMIT limit + 1: the extra row only tells us that another page exists, in
+// which case the cursor of the last written row is returned.
+static std::optional<std::string> writeProductRows(JsonWriter& out, sqlite3_stmt* stmt, int limit = -1,
+                                                   std::string (*cursorOf)(sqlite3_stmt*) = idCursor) {
+    out.beginArray();
+    int written = 0;
+    std::string lastCursor;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (written == limit) {
+            out.endArray();
+            return lastCursor;
+        }
+        writeProductRow(out, stmt);
+        ++written;
+        if (limit >= 0) {
+            lastCursor = cursorOf(stmt);
+        }
+    }
+    out.endArray();
+    return std::nullopt;
+}
+
+void writeAllProductsJson(JsonWriter& out) {
+    sqlite3* db = Database::get();
+    // Same order as the Catalog list
+    std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products ORDER BY id";
+
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
+        std::cerr << "Select Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+        out.beginArray();
+        out.endArray();
+        return;
+    }
+    writeProductRows(out, stmt);
+}
+
+void writeSearchResultsJson(JsonWriter& out, const std::string& query) {
+    auto stmt = prepareSearch(query, "", kSearchResultLimit);
+    if (!stmt) {
+        out.beginArray();
+        out.endArray();
+        return;
+    }
+    writeProductRows(out, stmt);
+}
+
+std::optional<std::string> writeProductsPageJson(JsonWriter& out, const std::string& afterId, int limit) {
+    sqlite3* db = Database::get();
+    // Walks the primary key index from the cursor, so every page costs O(limit)
+    std::string sql = "SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products "
+                      "WHERE id > ? ORDER BY id LIMIT ?";
+
+    auto stmt = Database::prepare(sql);
+    if (!stmt) {
+        std::cerr << "Select Page Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+        out.beginArray();
+        out.endArray();
+        return std::nullopt;
+    }
+
+    sqlite3_bind_text(stmt, 1, afterId.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, limit + 1);
+    return writeProductRows(out, stmt, limit);
+}
+
+std::optional<std::string> writeSearchPageJson(JsonWriter& out, const std::string& query, const std::string& after, int limit) {
+    auto stmt = prepareSearch(query, after, limit + 1);
+    if (!stmt) {
+        out.beginArray();
+        out.endArray();
+        return std::nullopt;
+    }
+    return writeProductRows(out, stmt, limit, searchCursor);
+}
+
+void writeProductLookupJson(JsonWriter& out, ProductKey by, const std::vector<std::string>& keys) {
+    // key -> encoded product, filled from a single query over the whole key set
+    std::unordered_map<std::string, std::string> found;
+    found.reserve(keys.size());
+
+    if (by == ProductKey::BARCODE && BarcodeIndex::loaded()) {
+        std::string json;
+        for (const auto& key : keys) {
+            if (BarcodeIndex::lookupJson(key, json)) found.emplace(key, json);
+        }
+    } else {
+        const char* column = by == ProductKey::ID ? "id" : by == ProductKey::SKU ? "sku" : "barcode";
+        // json_each expands the bound key array into a table SQLite can probe the column's index with
+        std::string sql = std::string("SELECT id, name, sku, barcode, category, stock, threshold, price, status FROM products "
+                                      "WHERE ") + column + " IN (SELECT value FROM json_each(?))";
+
+        auto stmt = Database::prepare(sql);
+        if (!stmt) {
+            std::cerr << "Lookup Prepare Failed: " << sqlite3_errmsg(Database::get()) << "\n";
+        } else {
+            JsonWriter keyArray;
+            keyArray.beginArray();
+            for (const auto& key : keys) keyArray.value(key);
+            keyArray.endArray();
+            sqlite3_bind_text(stmt, 1, keyArray.str().c_str(), -1, SQLITE_STATIC);
+
+            int keyColumn = by == ProductKey::ID ? 0 : by == ProductKey::SKU ? 2 : 3;
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                JsonWriter row;
+                writeProductRow(row, stmt);
+                found.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, keyColumn)), row.take());
+            }
+        }
+    }
+
+    out.beginArray();
+    for (const auto& key : keys) {
+        out.beginObject();
+        out.key("key"); out.value(key);
+        auto it = found.find(key);
+        out.key("found"); out.value(it != found.end());
+        if (it != found.end()) {
+            out.key("product"); out.raw(it->second);
+        }
+        out.endObject();
+    }
+    out.endArray();
+}
+
 bool updateProductInDB(
     const std::string& id,
     const std::string& name,
@@ -201,83 +405,267 @@ bool updateProductInDB(
     const std::string& category,
     int stock,
     int threshold,
-    double price,
-    ProductStatus status
+    double price
 ) {
-    sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
-    std::string sql = "UPDATE products SET name = ?, sku = ?, barcode = ?, category = ?, stock = ?, threshold = ?, price = ?, status = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?";
+    bool ok = WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        std::string sql = "UPDATE products SET name = ?, sku = ?, barcode = ?, category = ?, stock = ?, threshold = ?, price = ?, status = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?";
 
-    if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Update Prepare Failed: " << sqlite3_errmsg(db) << "\n";
-        return false;
-    }
+        auto stmt = Database::prepare(sql);
+        if(!stmt) {
+            std::cerr << "Update Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+            return false;
+        }
 
-    sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, sku.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, barcode.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, category.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 5, stock);
-    sqlite3_bind_int(stmt, 6, threshold);
-    sqlite3_bind_double(stmt, 7, price);
-    sqlite3_bind_text(stmt, 8, statusToString(status).c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 9, id.c_str(), -1, SQLITE_STATIC);
-
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if(!success) {
-        std::cerr << "Update Failed: " << sqlite3_errmsg(db) << "\n";
-    }
-    sqlite3_finalize(stmt);
-    return success;
+        std::string statusStr = statusToString(deriveStatus(stock, threshold));
+        sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, sku.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, barcode.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, category.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 5, stock);
+        sqlite3_bind_int(stmt, 6, threshold);
+        sqlite3_bind_double(stmt, 7, price);
+        sqlite3_bind_text(stmt, 8, statusStr.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 9, id.c_str(), -1, SQLITE_STATIC);
+
+        bool success = sqlite3_step(stmt) == SQLITE_DONE;
+        if(!success) {
+            std::cerr << "Update Failed: " << sqlite3_errmsg(db) << "\n";
+        }
+        return success;
+    });
+
+    if (ok) refreshProductCaches(id);
+    return ok;
 }
 
-bool deleteProductFromDB(const std::string& id) {
-    sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
+PatchResult patchProductInDB(const std::string& id, const ProductPatch& patch) {
+    // One statement per distinct field set (at most 2^9, in practice a handful), so the
+    // statement cache still applies. Each value is bound once as ?N and reused in the
+    // WHERE clause, which skips the write when every supplied value is already stored.
+    std::string sets, diffs;
+    std::vector<std::function<void(sqlite3_stmt*, int)>> binds;
+    auto field = [&](const char* column, auto bind) {
+        std::string param = "?" + std::to_string(binds.size() + 1);
+        sets += std::string(column) + " = " + param + ", ";
+        diffs += (diffs.empty() ? "" : " OR ") + std::string(column) + " IS NOT " + param;
+        binds.push_back(bind);
+    };
+    auto text = [](const std::string& v) {
+        return [&v](sqlite3_stmt* stmt, int i) { sqlite3_bind_text(stmt, i, v.c_str(), -1, SQLITE_STATIC); };
+    };
+    auto integer = [](int v) {
+        return [v](sqlite3_stmt* stmt, int i) { sqlite3_bind_int(stmt, i, v); };
+    };
+
+    if (patch.name) field("name", text(*patch.name));
+    if (patch.sku) field("sku", text(*patch.sku));
+    if (patch.barcode) field("barcode", text(*patch.barcode));
+    if (patch.category) field("category", text(*patch.category));
+    if (patch.description) field("description", text(*patch.description));
+    size_t stockParam = 0, thresholdParam = 0;
+    if (patch.stock) {
+        field("stock", integer(*patch.stock));
+        stockParam = binds.size();
+    }
+    if (patch.threshold) {
+        field("threshold", integer(*patch.threshold));
+        thresholdParam = binds.size();
+    }
+    if (patch.price) field("price", [v = *patch.price](sqlite3_stmt* stmt, int i) { sqlite3_bind_double(stmt, i, v); });
+    if (patch.stock || patch.threshold) {
+        std::string stock = patch.stock ? "?" + std::to_string(stockParam) : "stock";
+        std::string threshold = patch.threshold ? "?" + std::to_string(thresholdParam) : "threshold";
+        sets += "status = " + derivedStatusSql(stock, threshold) + ", ";
+    }
 
-    try {
-        char* errMsg = nullptr;
-        if(sqlite3_exec(db, "BEGIN;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
-            std::cerr << "Begin transaction failed: " << errMsg << "\n";
-            sqlite3_free(errMsg);
-            return false;
+    PatchResult result = PatchResult::FAILED;
+    bool ok = WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        const int idParam = static_cast<int>(binds.size()) + 1;
+
+        if (!binds.empty()) {
+            std::string sql = "UPDATE products SET " + sets + "updated_at = CURRENT_TIMESTAMP WHERE id = ?" +
+                              std::to_string(idParam) + " AND (" + diffs + ")";
+            auto stmt = Database::prepare(sql);
+            if (!stmt) {
+                std::cerr << "Patch Prepare Failed: " << sqlite3_errmsg(db) << "\n";
+                return false;
+            }
+            for (size_t i = 0; i < binds.size(); ++i) binds[i](stmt, static_cast<int>(i) + 1);
+            sqlite3_bind_text(stmt, idParam, id.c_str(), -1, SQLITE_STATIC);
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                result = sqlite3_errcode(db) == SQLITE_CONSTRAINT ? PatchResult::CONFLICT : PatchResult::FAILED;
+                std::cerr << "Patch Failed: " << sqlite3_errmsg(db) << "\n";
+                return false;
+            }
+            if (sqlite3_changes(db) > 0) {
+                result = PatchResult::UPDATED;
+                return true;
+            }
         }
 
-        std::string sql;
+        // Nothing written: either the row is missing or it already holds these values
+        auto exists = Database::prepare("SELECT 1 FROM products WHERE id = ?");
+        if (!exists) return false;
+        sqlite3_bind_text(exists, 1, id.c_str(), -1, SQLITE_STATIC);
+        result = sqlite3_step(exists) == SQLITE_ROW ? PatchResult::UNCHANGED : PatchResult::NOT_FOUND;
+        return true;
+    });
 
-        // Delete alerts
-        sql = "DELETE FROM alerts WHERE product_id = ?";
-        if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
-        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
-        if(sqlite3_step(stmt) != SQLITE_DONE) { sqlite3_finalize(stmt); return false; }
-        sqlite3_finalize(stmt);
+    if (!ok && result != PatchResult::CONFLICT) return PatchResult::FAILED;
+    if (result == PatchResult::UPDATED) refreshProductCaches(id);
+    return result;
+}
 
-        // Delete inventory_settings
-        sql = "DELETE FROM inventory_settings WHERE product_id = ?";
-        if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
-        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
-        if(sqlite3_step(stmt) != SQLITE_DONE) { sqlite3_finalize(stmt); return false; }
-        sqlite3_finalize(stmt);
+bool deleteProductFromDB(const std::string& id) {
+    // Runs in its own savepoint, so the three deletes land together or not at all
+    bool ok = WriteQueue::run([&] {
+        // Delete alerts, inventory_settings, then the product itself
+        const char* statements[] = {
+            "DELETE FROM alerts WHERE product_id = ?",
+            "DELETE FROM inventory_settings WHERE product_id = ?",
+            "DELETE FROM products WHERE id = ?"
+        };
+        for (const char* sql : statements) {
+            auto stmt = Database::prepare(sql);
+            if (!stmt) return false;
+            sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                std::cerr << "Delete Failed: " << sqlite3_errmsg(Database::get()) << "\n";
+                return false;
+            }
+        }
+        return true;
+    });
 
-        // Delete product
-        sql = "DELETE FROM products WHERE id = ?";
-        if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
-        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
-        if(sqlite3_step(stmt) != SQLITE_DONE) { sqlite3_finalize(stmt); return false; }
-        sqlite3_finalize(stmt);
+    // The re-read finds no row, so every cache drops the product, in order with full reloads
+    if (ok) refreshProductCaches(id);
+    return ok;
+}
 
-        if(sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
-            std::cerr << "Commit transaction failed: " << errMsg << "\n";
-            sqlite3_free(errMsg);
+std::vector<BulkRowResult> bulkUpsertProducts(const std::vector<Product>& products) {
+    std::vector<BulkRowResult> results(products.size());
+
+    // One op on the writer thread: a single transaction and a single prepared statement for every row.
+    // A failing row (e.g. duplicate barcode) only aborts its own statement.
+    bool committed = WriteQueue::run([&] {
+        sqlite3* db = Database::get();
+        std::string sql = "INSERT INTO products (id, name, sku, barcode, category, stock, threshold, price, status) "
+                          "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?) "
+                          "ON CONFLICT(sku) DO UPDATE SET name = excluded.name, barcode = excluded.barcode, "
+                          "category = excluded.category, stock = excluded.stock, threshold = excluded.threshold, "
+                          "price = excluded.price, status = excluded.status, updated_at = CURRENT_TIMESTAMP "
+                          "RETURNING id";
+
+        auto stmt = Database::prepare(sql);
+        if (!stmt) {
+            std::cerr << "Bulk Upsert Prepare Failed: " << sqlite3_errmsg(db) << "\n";
             return false;
         }
 
+        for (size_t i = 0; i < products.size(); ++i) {
+            const Product& p = products[i];
+            BulkRowResult& r = results[i];
+            std::string id = p.id.empty() ? generateUUID() : p.id;
+            std::string statusStr = statusToString(deriveStatus(p.stock, p.threshold));
+
+            sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, p.name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, p.sku.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 4, p.barcode.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 5, p.category.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 6, p.stock);
+            sqlite3_bind_int(stmt, 7, p.threshold);
+            sqlite3_bind_double(stmt, 8, p.price);
+            sqlite3_bind_text(stmt, 9, statusStr.c_str(), -1, SQLITE_STATIC);
+
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                r.ok = true;
+                r.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                r.inserted = r.id == id;
+                sqlite3_step(stmt);
+            } else {
+                r.error = sqlite3_errmsg(db);
+            }
+            sqlite3_reset(stmt);
+        }
         return true;
-    } catch(...) {
-        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
-        return false;
+    });
+
+    if (!committed) {
+        for (auto& r : results) {
+            r.ok = false;
+            r.inserted = false;
+            r.error = "Transaction failed";
+        }
+        return results;
+    }
+
+    std::vector<std::string> written;
+    written.reserve(results.size());
+    for (const auto& r : results) {
+        if (r.ok) written.push_back(r.id);
     }
+    refreshProductCaches(written);
+    return results;
+}
+
+// Held from each cache update's DB read until it is published. Without it a
+// full reload could read before a row write commits and publish after that
+// row's refresh, putting the old row back.
+static std::mutex cacheUpdate;
+
+void loadProductCaches() {
+    std::lock_guard<std::mutex> lock(cacheUpdate);
+    auto products = getAllProductsFromDB();
+    BarcodeIndex::rebuild(products);
+    Catalog::rebuild(products);
+    LowStockIndex::rebuild(products);
+    DataVersion::bump();
+    LiveFeed::resyncAll();
+}
+
+// Runs after the write has committed; re-reading the row keeps racing writers from leaving a stale entry
+void refreshProductCaches(const std::string& id) {
+    std::lock_guard<std::mutex> lock(cacheUpdate);
+    BarcodeIndex::refresh(id, [&id] {
+        auto row = getProductByIdFromDB(id);
+        // Still under the index's writer lock, so every cache settles on the same row
+        LiveFeed::productWritten(id, row);
+        Catalog::apply(id, row);
+        LowStockIndex::apply(id, row);
+        return row;
+    });
+    DataVersion::bump();
 }
+
+void refreshProductCaches(const std::vector<std::string>& ids) {
+    // Past a few thousand rows one table scan beats a point read per row
+    if (ids.size() > 2000) {
+        loadProductCaches();
+        return;
+    }
+    if (ids.empty()) return;
+
+    // The catalog takes the whole batch as one snapshot
+    std::lock_guard<std::mutex> lock(cacheUpdate);
+    std::vector<std::pair<std::string, std::optional<Product>>> rows;
+    rows.reserve(ids.size());
+    for (const auto& id : ids) {
+        BarcodeIndex::refresh(id, [&] {
+            auto row = getProductByIdFromDB(id);
+            LiveFeed::productWritten(id, row);
+            LowStockIndex::apply(id, row);
+            rows.emplace_back(id, row);
+            return row;
+        });
+    }
+    Catalog::apply(rows);
+    DataVersion::bump();
+}
+
 crow::json::wvalue productToJson(const Product& p) {
     crow::json::wvalue x;
     x["id"] = p.id;
@@ -303,17 +691,15 @@ crow::json::wvalue serializeProductsToJson(const std::vector<Product>& products)
 }
 
 std::vector<std::string> getAllCategoriesFromDB() {
-    sqlite3* db = Database::get();
-    sqlite3_stmt* stmt;
     std::vector<std::string> categories;
     std::string sql = "SELECT DISTINCT category FROM products WHERE category IS NOT NULL AND category != ''";
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    auto stmt = Database::prepare(sql);
+    if (!stmt)
         return categories;
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         categories.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
     }
-    sqlite3_finalize(stmt);
     return categories;
 }
 
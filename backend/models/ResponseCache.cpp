@@ -0,0 +1,97 @@
+#include "models/ResponseCache.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+    struct Entry {
+        uint64_t generation = 0;
+        std::string body;
+        mutable std::atomic<uint64_t> lastUsed{0};
+    };
+
+    const size_t kMaxEntries = 256;
+    const size_t kMaxBodyBytes = 64 * 1024 * 1024;
+
+    std::shared_mutex entriesMutex;
+    std::unordered_map<std::string, Entry> entries;
+    size_t entryBytes = 0;
+
+    std::atomic<uint64_t> useClock{0};
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+
+    size_t footprint(const std::string& key, const std::string& value) {
+        return key.size() + value.size();
+    }
+
+    // Caller holds entriesMutex exclusively. Stale generations go first, then least recently used.
+    void evictFor(size_t incoming, uint64_t generation) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.generation < generation) {
+                entryBytes -= footprint(it->first, it->second.body);
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        while (!entries.empty() && (entries.size() >= kMaxEntries || entryBytes + incoming > kMaxBodyBytes)) {
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.lastUsed.load(std::memory_order_relaxed) <
+                    oldest->second.lastUsed.load(std::memory_order_relaxed)) {
+                    oldest = it;
+                }
+            }
+            entryBytes -= footprint(oldest->first, oldest->second.body);
+            entries.erase(oldest);
+        }
+    }
+}
+
+namespace ResponseCache {
+    bool get(const std::string& key, uint64_t generation, std::string& body) {
+        std::shared_lock<std::shared_mutex> lock(entriesMutex);
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.generation != generation) {
+            missCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        it->second.lastUsed.store(useClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        body = it->second.body;
+        hitCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void put(const std::string& key, uint64_t generation, const std::string& body) {
+        size_t size = footprint(key, body);
+        if (size > kMaxBodyBytes) return;
+
+        std::unique_lock<std::shared_mutex> lock(entriesMutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            // A slower request built at an older generation must not replace a newer body
+            if (it->second.generation > generation) return;
+            entryBytes -= footprint(it->first, it->second.body);
+            entries.erase(it);
+        }
+        evictFor(size, generation);
+
+        Entry& entry = entries[key];
+        entry.generation = generation;
+        entry.body = body;
+        entry.lastUsed.store(useClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        entryBytes += size;
+    }
+
+    ResponseCacheStats stats() {
+        std::shared_lock<std::shared_mutex> lock(entriesMutex);
+        return {
+            hitCount.load(std::memory_order_relaxed),
+            missCount.load(std::memory_order_relaxed),
+            entries.size(),
+            entryBytes
+        };
+    }
+}
@@ -0,0 +1,241 @@
+#include "models/StockLedger.h"
+#include "db/Database.h"
+#include "db/WriteQueue.h"
+#include "models/Product.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread snapshotter;
+    bool running = false;
+    uint64_t snapshotEvery = 0;
+    std::chrono::seconds checkInterval{0};
+
+    bool exec(sqlite3* db, const char* sql) {
+        if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK) return true;
+        std::cerr << "[StockLedger] " << sql << " failed: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+
+    int64_t queryInt(const char* sql) {
+        auto stmt = Database::prepare(sql);
+        return stmt && sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : 0;
+    }
+
+    using StockMap = std::unordered_map<std::string, int64_t>;
+
+    // Sums the movements with id in (from, to] on the calling thread's own connection
+    void sumRange(int64_t from, int64_t to, StockMap& out) {
+        if (auto stmt = Database::prepare("SELECT product_id, delta FROM stock_movements WHERE id > ? AND id <= ?")) {
+            sqlite3_bind_int64(stmt, 1, from);
+            sqlite3_bind_int64(stmt, 2, to);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                auto id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                out[id] += sqlite3_column_int64(stmt, 1);
+            }
+        }
+        Database::release();
+    }
+
+    void snapshotLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            wake.wait_for(lock, checkInterval, [] { return !running; });
+            if (!running) break;
+            lock.unlock();
+            int64_t pending = queryInt("SELECT coalesce(max(id), 0) - "
+                                       "(SELECT coalesce(max(through_movement), 0) FROM stock_snapshots) FROM stock_movements");
+            if (pending >= static_cast<int64_t>(snapshotEvery) && StockLedger::snapshot()) {
+                std::cout << "[StockLedger] Snapshot after " << pending << " movements" << std::endl;
+            }
+            Database::release();
+            lock.lock();
+        }
+    }
+}
+
+namespace StockLedger {
+    bool snapshot(size_t keep) {
+        // Built from the ledger, not from products.stock, so a snapshot never bakes in drift
+        LedgerReplay replayed;
+        if (!replay(2, replayed)) return false;
+        if (keep == 0) keep = 1;
+
+        return WriteQueue::run([&] {
+            sqlite3* db = Database::get();
+            {
+                auto stmt = Database::prepare("INSERT INTO stock_snapshots (through_movement) VALUES (?)");
+                if (!stmt) return false;
+                sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(replayed.throughMovement));
+                if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+            }
+            sqlite3_int64 snapshotId = sqlite3_last_insert_rowid(db);
+
+            auto item = Database::prepare("INSERT INTO stock_snapshot_items (snapshot_id, product_id, stock) VALUES (?, ?, ?)");
+            if (!item) return false;
+            for (const auto& [productId, stock] : replayed.stock) {
+                if (stock == 0) continue;
+                sqlite3_bind_int64(item, 1, snapshotId);
+                sqlite3_bind_text(item, 2, productId.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int64(item, 3, stock);
+                if (sqlite3_step(item) != SQLITE_DONE) return false;
+                sqlite3_reset(item);
+            }
+
+            const char* prune[] = {
+                "DELETE FROM stock_snapshot_items WHERE snapshot_id NOT IN "
+                "(SELECT id FROM stock_snapshots ORDER BY id DESC LIMIT ?)",
+                "DELETE FROM stock_snapshots WHERE id NOT IN (SELECT id FROM stock_snapshots ORDER BY id DESC LIMIT ?)"
+            };
+            for (const char* sql : prune) {
+                auto stmt = Database::prepare(sql);
+                if (!stmt) return false;
+                sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(keep));
+                if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+            }
+            return true;
+        });
+    }
+
+    bool replay(size_t threads, LedgerReplay& out) {
+        sqlite3* db = Database::get();
+        if (!db) return false;
+        out = LedgerReplay{};
+
+        // Base and upper bound from one read snapshot; movements are never rewritten, so
+        // the range scans below can each use their own connection
+        int64_t through = 0;
+        {
+            bool ownTransaction = sqlite3_get_autocommit(db);
+            if (ownTransaction && !exec(db, "BEGIN;")) return false;
+            if (auto stmt = Database::prepare("SELECT id, through_movement FROM stock_snapshots ORDER BY id DESC LIMIT 1")) {
+                if (sqlite3_step(stmt) == SQLITE_ROW) {
+                    out.snapshotId = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+                    through = sqlite3_column_int64(stmt, 1);
+                }
+            }
+            if (out.snapshotId) {
+                if (auto stmt = Database::prepare("SELECT product_id, stock FROM stock_snapshot_items WHERE snapshot_id = ?")) {
+                    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(out.snapshotId));
+                    while (sqlite3_step(stmt) == SQLITE_ROW) {
+                        out.stock[reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))] = sqlite3_column_int64(stmt, 1);
+                    }
+                }
+            }
+            out.throughMovement = static_cast<uint64_t>(queryInt("SELECT coalesce(max(id), 0) FROM stock_movements"));
+            if (ownTransaction) exec(db, "COMMIT;");
+            Database::release();
+        }
+
+        int64_t last = static_cast<int64_t>(out.throughMovement);
+        if (last < through) last = through;
+        out.throughMovement = static_cast<uint64_t>(last);
+        out.movementsReplayed = static_cast<uint64_t>(last - through);
+
+        threads = std::max<size_t>(1, std::min<size_t>(threads, out.movementsReplayed / 10000 + 1));
+        std::vector<StockMap> partial(threads);
+        std::vector<std::thread> workers;
+        int64_t span = (last - through + static_cast<int64_t>(threads) - 1) / static_cast<int64_t>(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            int64_t from = through + static_cast<int64_t>(t) * span;
+            int64_t to = std::min(last, from + span);
+            if (t + 1 == threads) {
+                sumRange(from, to, partial[t]);   // the calling thread takes the last range
+            } else {
+                workers.emplace_back(sumRange, from, to, std::ref(partial[t]));
+            }
+        }
+        for (auto& w : workers) w.join();
+
+        for (const auto& part : partial) {
+            for (const auto& [productId, delta] : part) out.stock[productId] += delta;
+        }
+        return true;
+    }
+
+    bool compare(const LedgerReplay& replay, std::vector<LedgerDrift>& drift) {
+        sqlite3* db = Database::get();
+        if (!db) return false;
+        bool ownTransaction = sqlite3_get_autocommit(db);
+        if (ownTransaction && !exec(db, "BEGIN;")) return false;
+
+        StockMap stored;
+        if (auto stmt = Database::prepare("SELECT id, stock FROM products")) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                stored[reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))] = sqlite3_column_int64(stmt, 1);
+            }
+        }
+        // Take back what was written after the replay's upper bound
+        if (auto stmt = Database::prepare("SELECT product_id, sum(delta) FROM stock_movements WHERE id > ? GROUP BY product_id")) {
+            sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(replay.throughMovement));
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                stored[reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))] -= sqlite3_column_int64(stmt, 1);
+            }
+        }
+        if (ownTransaction) exec(db, "COMMIT;");
+
+        for (const auto& [productId, value] : stored) {
+            auto it = replay.stock.find(productId);
+            int64_t ledger = it == replay.stock.end() ? 0 : it->second;
+            if (value != ledger) drift.push_back({productId, value, ledger});
+        }
+        for (const auto& [productId, ledger] : replay.stock) {
+            if (ledger != 0 && !stored.count(productId)) drift.push_back({productId, 0, ledger});
+        }
+        std::sort(drift.begin(), drift.end(), [](const auto& a, const auto& b) { return a.productId < b.productId; });
+        return true;
+    }
+
+    bool correct(const std::vector<LedgerDrift>& drift) {
+        if (drift.empty()) return true;
+        static const std::string update = "UPDATE products SET stock = stock + ?1, status = " +
+                                          derivedStatusSql("stock + ?1", "threshold") +
+                                          ", updated_at = CURRENT_TIMESTAMP WHERE id = ?2";
+        return WriteQueue::run([&] {
+            sqlite3* db = Database::get();
+            if (!exec(db, "INSERT INTO stock_movement_context (record) VALUES (0);")) return false;
+            for (const auto& d : drift) {
+                // Relative, so movements that landed after the replay are kept
+                auto stmt = Database::prepare(update);
+                if (!stmt) return false;
+                sqlite3_bind_int64(stmt, 1, d.ledger - d.stored);
+                sqlite3_bind_text(stmt, 2, d.productId.c_str(), -1, SQLITE_STATIC);
+                if (sqlite3_step(stmt) != SQLITE_DONE) return false;
+                if (sqlite3_changes(db) > 0) continue;
+
+                // No product row to move: close the ledger's balance for it instead
+                auto entry = Database::prepare("INSERT INTO stock_movements (product_id, kind, delta, reference) "
+                                               "VALUES (?, 'adjust', ?, 'ledger correction')");
+                if (!entry) return false;
+                sqlite3_bind_text(entry, 1, d.productId.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int64(entry, 2, d.stored - d.ledger);
+                if (sqlite3_step(entry) != SQLITE_DONE) return false;
+            }
+            return exec(db, "DELETE FROM stock_movement_context;");
+        });
+    }
+
+    void start(uint64_t every, std::chrono::seconds interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        snapshotEvery = every;
+        checkInterval = interval;
+        running = true;
+        snapshotter = std::thread(snapshotLoop);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        snapshotter.join();
+    }
+}
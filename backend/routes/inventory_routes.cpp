@@ -1,43 +1,83 @@
 #include "routes/inventory_routes.h"
 #include "controllers/InventoryController.h"
 #include "middleware/CorsMiddleware.h"
+#include "middleware/DbLeaseMiddleware.h"
 
 template <typename App>
 void setupInventoryRoutes(App& app) {
-    CROW_ROUTE(app, "/api/inventory").methods("GET"_method)([]() {
-        return getInventoryOverview();
+    CROW_ROUTE(app, "/api/inventory").methods("GET"_method)([](const crow::request& req) {
+        return getInventoryOverview(req);
     });
-    CROW_ROUTE(app, "/api/inventory/stock/<int>").methods("PATCH"_method)([](const crow::request& req, int id) {
+    CROW_ROUTE(app, "/api/inventory/stock/<string>").methods("PATCH"_method)([](const crow::request& req, const std::string& id) {
         return updateStock(req, id);
     });
-    CROW_ROUTE(app, "/api/inventory/alerts").methods("GET"_method)([]() {
-        return getAlerts();
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/delta").methods("POST"_method)([](const crow::request& req, const std::string& id) {
+        return applyStockDelta(req, id);
     });
-    CROW_ROUTE(app, "/api/inventory/alerts/<int>").methods("DELETE"_method)([](int id) {
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/movements").methods("GET"_method)([](const crow::request& req, const std::string& id) {
+        return getStockMovements(req, id);
+    });
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/hot").methods("PUT"_method)([](const crow::request& req, const std::string& id) {
+        return promoteHotStock(req, id);
+    });
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/hot").methods("DELETE"_method)([](const std::string& id) {
+        return demoteHotStock(id);
+    });
+    CROW_ROUTE(app, "/api/inventory/hot").methods("GET"_method)([]() {
+        return getHotStock();
+    });
+    CROW_ROUTE(app, "/api/inventory/alerts").methods("GET"_method)([](const crow::request& req) {
+        return getAlerts(req);
+    });
+    CROW_ROUTE(app, "/api/inventory/low-stock").methods("GET"_method)([](const crow::request& req) {
+        return getLowStock(req);
+    });
+    CROW_ROUTE(app, "/api/inventory/out-of-stock").methods("GET"_method)([](const crow::request& req) {
+        return getOutOfStock(req);
+    });
+    CROW_ROUTE(app, "/api/inventory/alerts/<string>").methods("DELETE"_method)([](const std::string& id) {
         return deleteAlert(id);
     });
-    CROW_ROUTE(app, "/api/inventory/export").methods("POST"_method)([]() {
-        return exportInventory();
+    CROW_ROUTE(app, "/api/inventory/export").methods("POST"_method)([](const crow::request& req) {
+        return exportInventory(req);
     });
-    CROW_ROUTE(app, "/api/inventory/import").methods("POST"_method)([]() {
-        return importInventory();
+    CROW_ROUTE(app, "/api/inventory/import").methods("POST"_method)([](const crow::request& req) {
+        return importInventory(req);
     });
 
     // Explicit OPTIONS handlers:
     CROW_ROUTE(app, "/api/inventory").methods("OPTIONS"_method)
     ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
 
-    // For /stock/<int>
-    CROW_ROUTE(app, "/api/inventory/stock/<int>").methods("OPTIONS"_method)
-    ([](const crow::request&, crow::response& res, int) { res.code = 204; res.end(); });
+    // For /stock/<string>
+    CROW_ROUTE(app, "/api/inventory/stock/<string>").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res, const std::string&) { res.code = 204; res.end(); });
+
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/delta").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res, const std::string&) { res.code = 204; res.end(); });
+
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/movements").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res, const std::string&) { res.code = 204; res.end(); });
+
+    CROW_ROUTE(app, "/api/inventory/stock/<string>/hot").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res, const std::string&) { res.code = 204; res.end(); });
+
+    CROW_ROUTE(app, "/api/inventory/hot").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
 
     // For /alerts (no param)
     CROW_ROUTE(app, "/api/inventory/alerts").methods("OPTIONS"_method)
     ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
 
-    // For /alerts/<int>
-    CROW_ROUTE(app, "/api/inventory/alerts/<int>").methods("OPTIONS"_method)
-    ([](const crow::request&, crow::response& res, int) { res.code = 204; res.end(); });
+    CROW_ROUTE(app, "/api/inventory/low-stock").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
+
+    CROW_ROUTE(app, "/api/inventory/out-of-stock").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
+
+    // For /alerts/<string>
+    CROW_ROUTE(app, "/api/inventory/alerts/<string>").methods("OPTIONS"_method)
+    ([](const crow::request&, crow::response& res, const std::string&) { res.code = 204; res.end(); });
 
     CROW_ROUTE(app, "/api/inventory/export").methods("OPTIONS"_method)
     ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
@@ -46,4 +86,4 @@ void setupInventoryRoutes(App& app) {
     ([](const crow::request&, crow::response& res) { res.code = 204; res.end(); });
 }
 
-template void setupInventoryRoutes<crow::App<CORSHandler>>(crow::App<CORSHandler>&);
+template void setupInventoryRoutes<crow::App<CORSHandler, DbLeaseHandler>>(crow::App<CORSHandler, DbLeaseHandler>&);
@@ -0,0 +1,42 @@
+#include "routes/live_routes.h"
+#include "models/LiveFeed.h"
+#include "middleware/CorsMiddleware.h"
+#include "middleware/DbLeaseMiddleware.h"
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    uint64_t clientOf(crow::websocket::connection& conn) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(conn.userdata()));
+    }
+}
+
+template <typename App>
+void setupLiveRoutes(App& app) {
+    // WebSocket /api/live - stock, product and alert deltas (see models/LiveFeed.h).
+    // CROW_WEBSOCKET_ROUTE spelled out: the macro lacks the `template` keywords a dependent App needs.
+    app.template route<crow::black_magic::get_parameter_tag("/api/live")>("/api/live")
+        .template websocket<App>(&app)
+        .onopen([](crow::websocket::connection& conn) {
+            // send_text and close only queue work on the connection's io thread
+            uint64_t client = LiveFeed::subscribe(
+                [&conn](const std::string& frame) { conn.send_text(frame); },
+                [&conn] { conn.close("ack timeout"); });
+            conn.userdata(reinterpret_cast<void*>(static_cast<uintptr_t>(client)));
+        })
+        // Crow releases differ on whether a close code follows the reason
+        .onclose([](crow::websocket::connection& conn, const std::string&, auto&&...) {
+            LiveFeed::unsubscribe(clientOf(conn));
+        })
+        .onmessage([](crow::websocket::connection& conn, const std::string& data, bool) {
+            // {"ack":N}
+            auto pos = data.find("\"ack\"");
+            if (pos == std::string::npos) return;
+            pos = data.find(':', pos);
+            if (pos == std::string::npos) return;
+            uint64_t seq = std::strtoull(data.c_str() + pos + 1, nullptr, 10);
+            if (seq) LiveFeed::acknowledge(clientOf(conn), seq);
+        });
+}
+
+template void setupLiveRoutes<crow::App<CORSHandler, DbLeaseHandler>>(crow::App<CORSHandler, DbLeaseHandler>&);
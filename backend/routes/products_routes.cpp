@@ -2,12 +2,23 @@
 #include "controllers/ProductsController.h"
 #include "models/ProductModel.h"
 #include "middleware/CorsMiddleware.h"
+#include "middleware/DbLeaseMiddleware.h"
 
 template <typename App>
 void setupProductRoutes(App& app) {
-    // GET /api/products - List all products
-    CROW_ROUTE(app, "/api/products").methods("GET"_method)([] {
-        return getAllProducts();
+    // GET /api/products?limit=N&after=<cursor> - List products (paged when limit/after is given)
+    CROW_ROUTE(app, "/api/products").methods("GET"_method)([](const crow::request& req) {
+        return getAllProducts(req);
+    });
+
+    // GET /api/products/filter?min_stock=&max_stock=&min_price=&max_price=&below_threshold=1&category=&status=
+    CROW_ROUTE(app, "/api/products/filter").methods("GET"_method)([](const crow::request& req) {
+        return filterProducts(req);
+    });
+
+    // GET /api/products/changes?since=<seq>&limit=N - Change feed for delta sync
+    CROW_ROUTE(app, "/api/products/changes").methods("GET"_method)([](const crow::request& req) {
+        return getProductChanges(req);
     });
 
     // POST /api/products - Add new product
@@ -15,14 +26,24 @@ void setupProductRoutes(App& app) {
         return addProduct(req);
     });
 
+    // POST /api/products/lookup - Resolve many ids / SKUs / barcodes in one call
+    CROW_ROUTE(app, "/api/products/lookup").methods("POST"_method)([](const crow::request& req) {
+        return lookupProducts(req);
+    });
+
+    // POST /api/products/bulk - Create or update many products (matched by SKU) in one transaction
+    CROW_ROUTE(app, "/api/products/bulk").methods("POST"_method)([](const crow::request& req) {
+        return bulkUpsertProductList(req);
+    });
+
     // POST /api/products/import - Import products CSV file
     CROW_ROUTE(app, "/api/products/import").methods("POST"_method)([](const crow::request& req) {
         return importProducts(req);
     });
 
     // GET /api/products/export - Export products data as CSV
-    CROW_ROUTE(app, "/api/products/export").methods("GET"_method)([]() {
-        return exportProducts();
+    CROW_ROUTE(app, "/api/products/export").methods("GET"_method)([](const crow::request& req) {
+        return exportProducts(req);
     });
 
     // GET /api/products/<string> - Get single product by ID (string UUID)
@@ -31,14 +52,8 @@ void setupProductRoutes(App& app) {
     });
 
     // Categories route
-    CROW_ROUTE(app, "/api/products/categories").methods("GET"_method)([]() {
-        auto categories = getAllCategoriesFromDB();
-        crow::json::wvalue result;
-        size_t i = 0;
-        for (const auto& cat : categories) {
-            result[i++] = cat;
-        }
-        return crow::response{result};
+    CROW_ROUTE(app, "/api/products/categories").methods("GET"_method)([](const crow::request& req) {
+        return getCategories(req);
     });
 
 
@@ -47,20 +62,19 @@ void setupProductRoutes(App& app) {
         return updateProduct(req, id);
     });
 
+    // PATCH /api/products/<string> - Update only the supplied fields
+    CROW_ROUTE(app, "/api/products/<string>").methods("PATCH"_method)([](const crow::request& req, const std::string& id) {
+        return patchProduct(req, id);
+    });
+
     // DELETE /api/products/<string> - Delete product by ID
     CROW_ROUTE(app, "/api/products/<string>").methods("DELETE"_method)([](const std::string& id) {
         return deleteProduct(id);
     });
 
-    // GET /api/products/search?q=... - Search products
+    // GET /api/products/search?q=...&limit=N&after=<cursor> - Search products
     CROW_ROUTE(app, "/api/products/search").methods("GET"_method)([](const crow::request& req) {
-        auto query = req.url_params.get("q");
-        if (!query) {
-            return crow::response(400, "Missing search query");
-        }
-        auto results = searchProducts(query);
-        auto json = serializeProductsToJson(results);
-        return crow::response{json};
+        return searchProductList(req);
     });
 
 
@@ -96,6 +110,26 @@ void setupProductRoutes(App& app) {
         res.end();
     });
 
+    CROW_ROUTE(app, "/api/products/lookup").methods("OPTIONS"_method)([](const crow::request&, crow::response& res) {
+        res.code = 204;
+        res.end();
+    });
+
+    CROW_ROUTE(app, "/api/products/filter").methods("OPTIONS"_method)([](const crow::request&, crow::response& res) {
+        res.code = 204;
+        res.end();
+    });
+
+    CROW_ROUTE(app, "/api/products/changes").methods("OPTIONS"_method)([](const crow::request&, crow::response& res) {
+        res.code = 204;
+        res.end();
+    });
+
+    CROW_ROUTE(app, "/api/products/bulk").methods("OPTIONS"_method)([](const crow::request&, crow::response& res) {
+        res.code = 204;
+        res.end();
+    });
+
     // OPTIONS handler for preflight CORS
     CROW_ROUTE(app, "/api/products/import").methods("OPTIONS"_method)([](const crow::request&, crow::response& res) {
         res.code = 204;
@@ -109,4 +143,4 @@ void setupProductRoutes(App& app) {
     });
 }
 
-template void setupProductRoutes<crow::App<CORSHandler>>(crow::App<CORSHandler>&);
+template void setupProductRoutes<crow::App<CORSHandler, DbLeaseHandler>>(crow::App<CORSHandler, DbLeaseHandler>&);
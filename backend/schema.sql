@@ -31,3 +31,6 @@ CREATE TABLE alerts (
                         created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
                         FOREIGN KEY (product_id) REFERENCES products(id)
 );
+
+-- The products_fts full-text index, its sync triggers and rank are created by
+-- db/Schema.cpp on startup, when SQLite has FTS5
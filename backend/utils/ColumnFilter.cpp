@@ -0,0 +1,205 @@
+#include "utils/ColumnFilter.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define COLUMN_FILTER_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Scalar kernels: build each 64-row word bit by bit, `first` is the word's first row
+    template <typename Pred>
+    void scalarWords(size_t rows, size_t fromWord, ColumnFilter::Mask& mask, Pred pred) {
+        for (size_t w = fromWord; w < mask.size(); ++w) {
+            if (!mask[w]) continue;
+            size_t first = w * 64;
+            size_t end = std::min(rows, first + 64);
+            uint64_t bits = 0;
+            for (size_t i = first; i < end; ++i) {
+                bits |= static_cast<uint64_t>(pred(i)) << (i - first);
+            }
+            mask[w] &= bits;
+        }
+    }
+
+    bool detectAvx2() {
+#ifdef COLUMN_FILTER_AVX2
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    const bool hasAvx2 = detectAvx2();
+    std::atomic<bool> avx2Enabled{hasAvx2};
+
+#ifdef COLUMN_FILTER_AVX2
+    // Each AVX2 kernel covers whole 64-row words and returns how many it did;
+    // the scalar loop finishes the tail.
+
+    __attribute__((target("avx2")))
+    size_t betweenI32Avx2(const int32_t* col, size_t rows, int32_t lo, int32_t hi, ColumnFilter::Mask& mask) {
+        if (lo == INT32_MIN) return 0;
+        const __m256i low = _mm256_set1_epi32(lo - 1);   // x > lo - 1  <=>  x >= lo
+        const __m256i high = _mm256_set1_epi32(hi);
+        size_t words = rows / 64;
+        for (size_t w = 0; w < words; ++w) {
+            if (!mask[w]) continue;
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + w * 64 + k * 8));
+                __m256i in = _mm256_andnot_si256(_mm256_cmpgt_epi32(v, high), _mm256_cmpgt_epi32(v, low));
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(in))) << (k * 8);
+            }
+            mask[w] &= bits;
+        }
+        return words;
+    }
+
+    __attribute__((target("avx2")))
+    size_t betweenF64Avx2(const double* col, size_t rows, double lo, double hi, ColumnFilter::Mask& mask) {
+        const __m256d low = _mm256_set1_pd(lo);
+        const __m256d high = _mm256_set1_pd(hi);
+        size_t words = rows / 64;
+        for (size_t w = 0; w < words; ++w) {
+            if (!mask[w]) continue;
+            uint64_t bits = 0;
+            for (int k = 0; k < 16; ++k) {
+                __m256d v = _mm256_loadu_pd(col + w * 64 + k * 4);
+                __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, low, _CMP_GE_OQ), _mm256_cmp_pd(v, high, _CMP_LE_OQ));
+                bits |= static_cast<uint64_t>(_mm256_movemask_pd(in)) << (k * 4);
+            }
+            mask[w] &= bits;
+        }
+        return words;
+    }
+
+    __attribute__((target("avx2")))
+    size_t lessI32Avx2(const int32_t* a, const int32_t* b, size_t rows, ColumnFilter::Mask& mask) {
+        size_t words = rows / 64;
+        for (size_t w = 0; w < words; ++w) {
+            if (!mask[w]) continue;
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k) {
+                __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w * 64 + k * 8));
+                __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w * 64 + k * 8));
+                __m256i in = _mm256_cmpgt_epi32(vb, va);
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(in))) << (k * 8);
+            }
+            mask[w] &= bits;
+        }
+        return words;
+    }
+
+    __attribute__((target("avx2")))
+    size_t equalsU32Avx2(const uint32_t* col, size_t rows, uint32_t value, ColumnFilter::Mask& mask) {
+        const __m256i needle = _mm256_set1_epi32(static_cast<int32_t>(value));
+        size_t words = rows / 64;
+        for (size_t w = 0; w < words; ++w) {
+            if (!mask[w]) continue;
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + w * 64 + k * 8));
+                __m256i in = _mm256_cmpeq_epi32(v, needle);
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(in))) << (k * 8);
+            }
+            mask[w] &= bits;
+        }
+        return words;
+    }
+
+    __attribute__((target("avx2")))
+    size_t equalsU8Avx2(const uint8_t* col, size_t rows, uint8_t value, ColumnFilter::Mask& mask) {
+        const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+        size_t words = rows / 64;
+        for (size_t w = 0; w < words; ++w) {
+            if (!mask[w]) continue;
+            __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + w * 64));
+            __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + w * 64 + 32));
+            uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, needle))) |
+                            static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, needle)))) << 32;
+            mask[w] &= bits;
+        }
+        return words;
+    }
+#endif
+
+    bool avx2() {
+        return avx2Enabled.load(std::memory_order_relaxed);
+    }
+}
+
+namespace ColumnFilter {
+    Isa isa() {
+        return avx2() ? Isa::AVX2 : Isa::SCALAR;
+    }
+
+    void useIsa(Isa requested) {
+        avx2Enabled.store(requested == Isa::AVX2 && hasAvx2, std::memory_order_relaxed);
+    }
+
+    Mask all(size_t rows) {
+        Mask mask((rows + 63) / 64, ~uint64_t{0});
+        if (rows % 64) mask.back() = (uint64_t{1} << (rows % 64)) - 1;
+        return mask;
+    }
+
+    void between(const int32_t* col, size_t rows, int32_t lo, int32_t hi, Mask& mask) {
+        size_t done = 0;
+#ifdef COLUMN_FILTER_AVX2
+        if (avx2()) done = betweenI32Avx2(col, rows, lo, hi, mask);
+#endif
+        scalarWords(rows, done, mask, [=](size_t i) { return col[i] >= lo && col[i] <= hi; });
+    }
+
+    void between(const double* col, size_t rows, double lo, double hi, Mask& mask) {
+        size_t done = 0;
+#ifdef COLUMN_FILTER_AVX2
+        if (avx2()) done = betweenF64Avx2(col, rows, lo, hi, mask);
+#endif
+        scalarWords(rows, done, mask, [=](size_t i) { return col[i] >= lo && col[i] <= hi; });
+    }
+
+    void less(const int32_t* a, const int32_t* b, size_t rows, Mask& mask) {
+        size_t done = 0;
+#ifdef COLUMN_FILTER_AVX2
+        if (avx2()) done = lessI32Avx2(a, b, rows, mask);
+#endif
+        scalarWords(rows, done, mask, [=](size_t i) { return a[i] < b[i]; });
+    }
+
+    void equals(const uint32_t* col, size_t rows, uint32_t value, Mask& mask) {
+        size_t done = 0;
+#ifdef COLUMN_FILTER_AVX2
+        if (avx2()) done = equalsU32Avx2(col, rows, value, mask);
+#endif
+        scalarWords(rows, done, mask, [=](size_t i) { return col[i] == value; });
+    }
+
+    void equals(const uint8_t* col, size_t rows, uint8_t value, Mask& mask) {
+        size_t done = 0;
+#ifdef COLUMN_FILTER_AVX2
+        if (avx2()) done = equalsU8Avx2(col, rows, value, mask);
+#endif
+        scalarWords(rows, done, mask, [=](size_t i) { return col[i] == value; });
+    }
+
+    size_t count(const Mask& mask) {
+        size_t n = 0;
+        for (uint64_t word : mask) n += static_cast<size_t>(std::popcount(word));
+        return n;
+    }
+
+    void select(const Mask& mask, std::vector<uint32_t>& selection, size_t limit) {
+        for (size_t w = 0; w < mask.size(); ++w) {
+            uint64_t bits = mask[w];
+            while (bits) {
+                if (selection.size() >= limit) return;
+                selection.push_back(static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+}
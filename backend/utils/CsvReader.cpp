@@ -0,0 +1,218 @@
+#include "utils/CsvReader.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CSV_READER_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // One bit per byte of a 64-byte block
+    struct Masks {
+        uint64_t quotes;
+        uint64_t commas;
+        uint64_t newlines;
+    };
+
+    // Bit k set if byte k of `word` (the k-th in memory) equals `c`
+    uint64_t matchWord(uint64_t word, char c) {
+        const uint64_t low7 = 0x7f7f7f7f7f7f7f7full;
+        uint64_t x = word ^ (0x0101010101010101ull * static_cast<unsigned char>(c));
+        uint64_t high = ~(((x & low7) + low7) | x) & 0x8080808080808080ull;   // high bit of each zero byte
+        return (high >> 7) * 0x0102040810204080ull >> 56;
+    }
+
+    // Eight bytes at a time in general-purpose registers
+    Masks classifyScalar(const char* p) {
+        Masks m{0, 0, 0};
+        for (int i = 0; i < 8; ++i) {
+            uint64_t word = 0;
+            for (int k = 0; k < 8; ++k) word |= static_cast<uint64_t>(static_cast<unsigned char>(p[i * 8 + k])) << (k * 8);
+            m.quotes |= matchWord(word, '"') << (i * 8);
+            m.commas |= matchWord(word, ',') << (i * 8);
+            m.newlines |= matchWord(word, '\n') << (i * 8);
+        }
+        return m;
+    }
+
+    bool detectAvx2() {
+#ifdef CSV_READER_AVX2
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    const bool hasAvx2 = detectAvx2();
+    std::atomic<bool> avx2Enabled{hasAvx2};
+
+#ifdef CSV_READER_AVX2
+    __attribute__((target("avx2")))
+    uint64_t matchAvx2(__m256i lo, __m256i hi, char c) {
+        const __m256i needle = _mm256_set1_epi8(c);
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle))) |
+               static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)))) << 32;
+    }
+
+    __attribute__((target("avx2")))
+    Masks classifyAvx2(const char* p) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        return {matchAvx2(lo, hi, '"'), matchAvx2(lo, hi, ','), matchAvx2(lo, hi, '\n')};
+    }
+#endif
+
+    bool avx2() {
+        return avx2Enabled.load(std::memory_order_relaxed);
+    }
+
+    // Block at `at`; a short tail is zero-padded, which adds no structure
+    Masks classify(std::string_view data, size_t at) {
+        const char* p = data.data() + at;
+        char tail[64];
+        if (data.size() - at < 64) {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, p, data.size() - at);
+            p = tail;
+        }
+#ifdef CSV_READER_AVX2
+        if (avx2()) return classifyAvx2(p);
+#endif
+        return classifyScalar(p);
+    }
+
+    // Bit i = parity of the quotes at or before i, i.e. byte i is inside quotes
+    // (an opening quote counts as inside, a closing one doesn't)
+    uint64_t prefixXor(uint64_t x) {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+    // All ones if the block ends inside quotes
+    uint64_t carryOut(uint64_t inside) {
+        return 0 - (inside >> 63);
+    }
+
+    bool blank(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    // Commas and line feeds outside quotes in the block at `at`; `carry` is all
+    // ones while inside quotes and is updated for the next block
+    uint64_t separatorsAt(std::string_view data, size_t at, uint64_t& carry) {
+        Masks m = classify(data, at);
+        uint64_t inside = prefixXor(m.quotes) ^ carry;
+        carry = carryOut(inside);
+        return (m.commas | m.newlines) & ~inside;
+    }
+
+    std::string_view trim(const char* begin, const char* end) {
+        while (begin < end && blank(*begin)) ++begin;
+        while (begin < end && (blank(end[-1]) || end[-1] == '\r')) --end;
+        return {begin, static_cast<size_t>(end - begin)};
+    }
+}
+
+CsvReader::Isa CsvReader::isa() {
+    return avx2() ? Isa::AVX2 : Isa::SCALAR;
+}
+
+void CsvReader::useIsa(Isa requested) {
+    avx2Enabled.store(requested == Isa::AVX2 && hasAvx2, std::memory_order_relaxed);
+}
+
+size_t CsvReader::recordBoundary(std::string_view data, size_t from, size_t target) {
+    // A boundary is one past an unquoted line feed, so look from the byte before the goal
+    size_t first = from + std::max<size_t>(target, 1) - 1;
+    if (first >= data.size()) return data.size();
+
+    // Whole blocks before it only decide whether we're inside quotes there
+    uint64_t carry = 0;
+    size_t at = from;
+    for (; at + 64 <= first; at += 64) {
+        if (std::popcount(classify(data, at).quotes) & 1) carry = ~carry;
+    }
+    for (; at < data.size(); at += 64) {
+        Masks m = classify(data, at);
+        uint64_t inside = prefixXor(m.quotes) ^ carry;
+        carry = carryOut(inside);
+        uint64_t newlines = m.newlines & ~inside;
+        if (at < first) newlines &= ~uint64_t{0} << (first - at);
+        if (newlines) return at + std::countr_zero(newlines) + 1;
+    }
+    return data.size();
+}
+
+CsvReader::CsvReader(std::string_view data) : data(data) {
+    if (!data.empty()) separators = separatorsAt(data, 0, inQuotes);
+}
+
+std::string_view CsvReader::field(const char* begin, const char* end) {
+    std::string_view v = trim(begin, end);
+    if (v.empty() || v.front() != '"') return v;
+
+    std::string_view inner = v.substr(1);
+    if (!inner.empty() && inner.back() == '"') inner.remove_suffix(1);
+    bool escaped = false;
+    for (char c : inner) {
+        nextLine += c == '\n';
+        escaped |= c == '"';
+    }
+    if (!escaped) return inner;
+
+    std::string& out = unescaped.emplace_back();
+    out.reserve(inner.size());
+    for (size_t i = 0; i < inner.size(); ++i) {
+        out += inner[i];
+        if (inner[i] == '"' && i + 1 < inner.size() && inner[i + 1] == '"') ++i;
+    }
+    return out;
+}
+
+bool CsvReader::next(std::vector<std::string_view>& fields) {
+    fields.clear();
+    unescaped.clear();
+    openQuote = false;
+    if (pos >= data.size()) return false;
+    recordLine = nextLine++;
+
+    // The scan runs on locals: pushing into `fields` could otherwise alias them
+    const std::string_view in = data;
+    size_t at = block;
+    uint64_t bits = separators;
+    uint64_t carry = inQuotes;
+    size_t begin = pos;
+    while (true) {
+        while (!bits) {
+            at += 64;
+            if (at >= in.size()) {
+                block = at;
+                separators = 0;
+                inQuotes = carry;
+                fields.push_back(field(in.data() + begin, in.data() + in.size()));
+                pos = in.size();
+                openQuote = carry != 0;
+                return true;
+            }
+            bits = separatorsAt(in, at, carry);
+        }
+        size_t end = at + std::countr_zero(bits);
+        bits &= bits - 1;
+        fields.push_back(field(in.data() + begin, in.data() + end));
+        begin = end + 1;
+        if (in[end] == '\n') break;
+    }
+    block = at;
+    separators = bits;
+    inQuotes = carry;
+    pos = begin;
+    return true;
+}
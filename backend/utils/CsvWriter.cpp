@@ -0,0 +1,61 @@
+#include "utils/CsvWriter.h"
+#include <charconv>
+#include <cstring>
+
+CsvWriter::CsvWriter(std::FILE* out, size_t bufferBytes) : out(out), buf(bufferBytes < 64 ? 64 : bufferBytes) {}
+
+bool CsvWriter::flush() {
+    if (used && !failed) {
+        failed = std::fwrite(buf.data(), 1, used, out) != used;
+        written += used;
+    }
+    used = 0;
+    return !failed;
+}
+
+void CsvWriter::append(const char* data, size_t n) {
+    if (n > buf.size() - used) {
+        flush();
+        // Larger than the whole buffer: straight to the stream
+        if (n > buf.size()) {
+            if (!failed) failed = std::fwrite(data, 1, n, out) != n;
+            written += n;
+            return;
+        }
+    }
+    std::memcpy(buf.data() + used, data, n);
+    used += n;
+}
+
+void CsvWriter::value(std::string_view s) {
+    separate();
+    put('"');
+    size_t quote;
+    while ((quote = s.find('"')) != std::string_view::npos) {
+        append(s.data(), quote + 1);
+        put('"');
+        s.remove_prefix(quote + 1);
+    }
+    append(s.data(), s.size());
+    put('"');
+}
+
+void CsvWriter::value(int64_t n) {
+    separate();
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), n);
+    append(digits, static_cast<size_t>(end - digits));
+}
+
+void CsvWriter::value(double d) {
+    separate();
+    // Shortest text that reads back as the same double
+    char digits[32];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), d);
+    append(digits, static_cast<size_t>(end - digits));
+}
+
+void CsvWriter::endRow() {
+    put('\n');
+    rowStarted = false;
+}
@@ -0,0 +1,107 @@
+#include "utils/Epoch.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+namespace {
+    // Upper bound on threads inside a guard at once (Crow workers, writer, background jobs)
+    constexpr size_t kMaxThreads = 512;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};   // 0 = not reading
+        std::atomic<bool> taken{false};
+    };
+
+    Slot slots[kMaxThreads];
+    std::atomic<uint64_t> globalEpoch{1};
+
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> destroy;
+    };
+
+    std::mutex retiredMutex;
+    std::vector<Retired> retired;
+
+    // Claims a slot for the calling thread on first use and frees it on thread exit
+    struct ThreadSlot {
+        Slot* slot = nullptr;
+        unsigned depth = 0;
+
+        Slot* get() {
+            if (slot) return slot;
+            for (auto& s : slots) {
+                bool expected = false;
+                if (s.taken.compare_exchange_strong(expected, true)) {
+                    slot = &s;
+                    return slot;
+                }
+            }
+            std::cerr << "[Epoch] More than " << kMaxThreads << " reader threads" << std::endl;
+            std::terminate();
+        }
+
+        ~ThreadSlot() {
+            if (slot) {
+                slot->epoch.store(0);
+                slot->taken.store(false);
+            }
+        }
+    };
+
+    thread_local ThreadSlot self;
+
+    uint64_t oldestActiveEpoch() {
+        uint64_t oldest = UINT64_MAX;
+        for (auto& s : slots) {
+            uint64_t e = s.epoch.load();
+            if (e != 0 && e < oldest) oldest = e;
+        }
+        return oldest;
+    }
+}
+
+namespace Epoch {
+    Guard::Guard() : outermost(self.depth++ == 0) {
+        if (!outermost) return;
+        Slot* slot = self.get();
+        // Announce the epoch we read in; seq_cst orders this before any pointer loads
+        slot->epoch.store(globalEpoch.load());
+    }
+
+    Guard::~Guard() {
+        --self.depth;
+        if (outermost) {
+            self.slot->epoch.store(0);
+        }
+    }
+
+    void retire(std::function<void()> destroy) {
+        // Everything unlinked before this point is invisible to guards entered after it
+        uint64_t epoch = globalEpoch.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            retired.push_back({epoch, std::move(destroy)});
+        }
+        collect();
+    }
+
+    size_t collect() {
+        std::vector<std::function<void()>> ready;
+        size_t pending;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            uint64_t oldest = oldestActiveEpoch();
+            auto keep = retired.begin();
+            for (auto& r : retired) {
+                if (r.epoch < oldest) ready.push_back(std::move(r.destroy));
+                else *keep++ = std::move(r);
+            }
+            retired.erase(keep, retired.end());
+            pending = retired.size();
+        }
+        for (auto& destroy : ready) destroy();
+        return pending;
+    }
+}
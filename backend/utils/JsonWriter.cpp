@@ -0,0 +1,81 @@
+#include "utils/JsonWriter.h"
+#include <charconv>
+#include <cmath>
+
+void JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    buf += ':';
+    needComma = false;
+}
+
+void JsonWriter::value(std::string_view s) {
+    separate();
+    appendEscaped(s);
+    needComma = true;
+}
+
+void JsonWriter::value(const char* s) {
+    if (!s) {
+        null();
+        return;
+    }
+    value(std::string_view(s));
+}
+
+void JsonWriter::value(int64_t n) {
+    separate();
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), n);
+    buf.append(tmp, end);
+    needComma = true;
+}
+
+void JsonWriter::value(uint64_t n) {
+    separate();
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), n);
+    buf.append(tmp, end);
+    needComma = true;
+}
+
+void JsonWriter::value(double d) {
+    // JSON has no NaN/Infinity
+    if (!std::isfinite(d)) {
+        null();
+        return;
+    }
+    separate();
+    char tmp[32];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), d);
+    buf.append(tmp, end);
+    needComma = true;
+}
+
+void JsonWriter::appendEscaped(std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    buf += '"';
+    size_t run = 0;  // start of the current run of bytes that need no escaping
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        buf.append(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': buf += "\\\""; break;
+            case '\\': buf += "\\\\"; break;
+            case '\n': buf += "\\n"; break;
+            case '\r': buf += "\\r"; break;
+            case '\t': buf += "\\t"; break;
+            case '\b': buf += "\\b"; break;
+            case '\f': buf += "\\f"; break;
+            default:
+                buf += "\\u00";
+                buf += hex[c >> 4];
+                buf += hex[c & 0xf];
+        }
+    }
+    buf.append(s.data() + run, s.size() - run);
+    buf += '"';
+}
@@ -1,7 +1,7 @@
 "use client"
 
 import { useState, useEffect, useCallback } from "react"
-import { inventoryApi, type InventoryItem, type InventoryAlert } from "@/lib/api"
+import { inventoryApi, subscribeLive, type InventoryItem, type InventoryAlert } from "@/lib/api"
 import { toast } from "sonner"
 
 export function useInventory() {
@@ -90,7 +90,7 @@ export function useInventory() {
         const url = URL.createObjectURL(response.data as Blob)
         const link = document.createElement("a")
         link.href = url
-        link.download = `inventory-report-${new Date().toISOString().split("T")[0]}.json`
+        link.download = `inventory-report-${new Date().toISOString().split("T")[0]}.csv`
         document.body.appendChild(link)
         link.click()
         document.body.removeChild(link)
@@ -118,18 +118,27 @@ export function useInventory() {
         const response = await inventoryApi.updateStock(productId, quantity, operation)
 
         if (response.success && response.data) {
-          setInventory((prev) => prev.map((item) => (item.id === productId ? response.data! : item)))
-
-          // Recalculate summary
-          const updatedItem = response.data
-          setSummary((prev) => ({
-            ...prev,
-            totalValue: prev.totalValue - (inventory.find((i) => i.id === productId)?.value || 0) + updatedItem.value,
-            totalItems:
-              prev.totalItems -
-              (inventory.find((i) => i.id === productId)?.currentStock || 0) +
-              updatedItem.currentStock,
-          }))
+          // The server answers with the product; fold its new stock into the inventory row.
+          // A hot product's change arrives over the live feed once it is flushed.
+          const product = "hot" in response.data ? undefined : response.data
+          const previous = inventory.find((i) => i.id === productId)
+          const updatedItem = previous && product
+            ? {
+                ...previous,
+                currentStock: product.stock,
+                minStock: product.threshold,
+                value: product.stock * previous.price,
+                lastUpdated: new Date().toISOString(),
+              }
+            : undefined
+          if (updatedItem) {
+            setInventory((prev) => prev.map((item) => (item.id === productId ? updatedItem : item)))
+            setSummary((prev) => ({
+              ...prev,
+              totalValue: prev.totalValue - previous!.value + updatedItem.value,
+              totalItems: prev.totalItems - previous!.currentStock + updatedItem.currentStock,
+            }))
+          }
 
           toast.success("Stock Updated", {
             description: "Stock levels have been updated successfully.",
@@ -163,10 +172,11 @@ export function useInventory() {
         const response = await inventoryApi.importData(file)
 
         if (response.ok) {
+          const report: { imported: number; failed: number; rows_per_sec: number } = await response.json()
           await fetchInventory()
           await fetchAlerts()
           toast.success("Data Imported", {
-            description: "Inventory data has been imported successfully.",
+            description: `Imported ${report.imported} rows${report.failed ? `, ${report.failed} failed` : ""} (${Math.round(report.rows_per_sec)} rows/s).`,
           })
         } else {
           const errorData = await response.json()
@@ -189,6 +199,34 @@ export function useInventory() {
     fetchAlerts()
   }, [fetchInventory, fetchAlerts])
 
+  // Pushed stock and alert changes replace polling after each action
+  useEffect(() => {
+    return subscribeLive({
+      onEvents: (events) => {
+        for (const event of events) {
+          if (event.type === "stock") {
+            setInventory((prev) =>
+              prev.map((item) =>
+                item.id === event.id ? { ...item, currentStock: event.stock, minStock: event.threshold } : item,
+              ),
+            )
+          } else if (event.type === "alerts") {
+            setAlerts((prev) => [...event.alerts, ...prev.filter((alert) => alert.product_id !== event.product_id)])
+          } else if (event.type === "alert-dismissed") {
+            setAlerts((prev) => prev.filter((alert) => alert.id !== event.id))
+          } else if (event.type === "product-removed") {
+            setInventory((prev) => prev.filter((item) => item.id !== event.id))
+            setAlerts((prev) => prev.filter((alert) => alert.product_id !== event.id))
+          }
+        }
+      },
+      onResync: () => {
+        fetchInventory()
+        fetchAlerts()
+      },
+    })
+  }, [fetchInventory, fetchAlerts])
+
   return {
     inventory,
     alerts,
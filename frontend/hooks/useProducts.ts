@@ -1,7 +1,7 @@
 "use client"
 
 import { useState, useEffect, useCallback } from "react"
-import { productApi, type Product } from "@/lib/api"
+import { productApi, subscribeLive, type Product } from "@/lib/api"
 import { toast } from "sonner"
 
 export function useProducts() {
@@ -196,7 +196,7 @@ export function useProducts() {
         const url = URL.createObjectURL(response.data as Blob)
         const link = document.createElement("a")
         link.href = url
-        link.download = `products-export-${new Date().toISOString().split("T")[0]}.json`
+        link.download = `products-export-${new Date().toISOString().split("T")[0]}.csv`
         document.body.appendChild(link)
         link.click()
         document.body.removeChild(link)
@@ -224,10 +224,11 @@ export function useProducts() {
         const response = await productApi.importData(file)
 
         if (response.ok) {
+          const report: { imported: number; failed: number; rows_per_sec: number } = await response.json()
           await fetchProducts()
           await fetchCategories()
           toast.success("Data Imported", {
-            description: "Product data has been imported successfully.",
+            description: `Imported ${report.imported} rows${report.failed ? `, ${report.failed} failed` : ""} (${Math.round(report.rows_per_sec)} rows/s).`,
           })
         } else {
           const errorData = await response.json()
@@ -250,6 +251,34 @@ export function useProducts() {
     fetchCategories()
   }, [fetchProducts, fetchCategories])
 
+  // Apply pushed changes to the loaded list instead of polling; products outside
+  // the current filter are left for the next fetch
+  useEffect(() => {
+    return subscribeLive({
+      onEvents: (events) => {
+        setProducts((prev) => {
+          let next = prev
+          for (const event of events) {
+            if (event.type === "stock") {
+              next = next.map((p) =>
+                p.id === event.id ? { ...p, stock: event.stock, threshold: event.threshold, status: event.status } : p,
+              )
+            } else if (event.type === "product") {
+              next = next.map((p) => (p.id === event.product.id ? { ...p, ...event.product } : p))
+            } else if (event.type === "product-removed") {
+              next = next.filter((p) => p.id !== event.id)
+            }
+          }
+          return next
+        })
+      },
+      onResync: () => {
+        fetchProducts()
+        fetchCategories()
+      },
+    })
+  }, [fetchProducts, fetchCategories])
+
   return {
     products,
     categories,
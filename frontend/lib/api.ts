@@ -24,6 +24,12 @@ export interface Product {
   updated_at: string
 }
 
+export interface ProductLookupResult {
+  key: string
+  found: boolean
+  product?: Product
+}
+
 export interface InventoryItem {
   id: string
   name: string
@@ -47,6 +53,30 @@ export interface InventoryAlert {
   created_at: string
 }
 
+export interface StockMovement {
+  id: number
+  kind: "receive" | "pick" | "adjust" | "transfer"
+  delta: number
+  reference: string | null
+  created_at: string
+}
+
+// Answer to a stock change on a hot product: accepted, written to the database by the next flush
+export interface HotStockAck {
+  id: string
+  delta: number
+  hot: true
+}
+
+export interface HotStockStats {
+  id: string
+  headroom: number
+  budget: number
+  pending: number
+  flushed_stock: number
+  flushes: number
+}
+
 export interface InventoryOverview {
   items: InventoryItem[]
   summary: {
@@ -158,6 +188,14 @@ export const productApi = {
     })
   },
 
+  // Sends only the changed fields; unchanged values are not written
+  patch: async (id: string, changes: Partial<Product>) => {
+    return apiCall<{ message: string }>(`/products/${id}`, {
+      method: "PATCH",
+      body: JSON.stringify(changes),
+    })
+  },
+
   delete: async (id: string) => {
     return apiCall<{ message: string }>(`/products/${id}`, {
       method: "DELETE",
@@ -168,6 +206,45 @@ export const productApi = {
     return apiCall<Product[]>(`/products/search?q=${encodeURIComponent(query)}`)
   },
 
+  // Resolves many ids / SKUs / barcodes in one request; results keep the input order
+  lookup: async (keys: { ids?: string[]; skus?: string[]; barcodes?: string[] }) => {
+    return apiCall<Record<"ids" | "skus" | "barcodes", ProductLookupResult[]>>("/products/lookup", {
+      method: "POST",
+      body: JSON.stringify(keys),
+    })
+  },
+
+  // Server-side filter over the in-memory catalog; unset fields match everything
+  filter: async (params: {
+    min_stock?: number
+    max_stock?: number
+    min_price?: number
+    max_price?: number
+    below_threshold?: boolean
+    category?: string
+    status?: Product["status"]
+    limit?: number
+  }) => {
+    const query = new URLSearchParams()
+    Object.entries(params).forEach(([key, value]) => {
+      if (value !== undefined) query.set(key, typeof value === "boolean" ? (value ? "1" : "0") : String(value))
+    })
+    return apiCall<{ total: number; items: Product[] }>(`/products/filter?${query}`)
+  },
+
+  // Delta sync: changes after `since` with each product's current state (null once deleted).
+  // A 410 error means the log was compacted past `since`; refetch everything and restart from `latest`.
+  changes: async (since: number, limit?: number) => {
+    const query = new URLSearchParams({ since: String(since) })
+    if (limit !== undefined) query.set("limit", String(limit))
+    return apiCall<{
+      changes: { seq: number; op: "insert" | "update" | "delete"; id: string; changed_at: string; product: Product | null }[]
+      next: number
+      latest: number
+      has_more: boolean
+    }>(`/products/changes?${query}`)
+  },
+
   scanBarcode: async (barcode: string) => {
     return apiCall<Product>(`/products/scan/${barcode}`)
   },
@@ -226,12 +303,45 @@ export const inventoryApi = {
   },
 
   updateStock: async (productId: string, quantity: number, operation: "add" | "subtract" | "set") => {
-    return apiCall<InventoryItem>(`/inventory/stock/${productId}`, {
+    return apiCall<Product | HotStockAck>(`/inventory/stock/${productId}`, {
       method: "PATCH",
       body: JSON.stringify({ quantity, operation }),
     })
   },
 
+  // Atomic stock = stock + delta, recorded in the movement ledger; 409 if stock would go negative
+  applyDelta: async (
+    productId: string,
+    delta: number,
+    kind?: StockMovement["kind"],
+    reference?: string
+  ) => {
+    return apiCall<Product | HotStockAck>(`/inventory/stock/${productId}/delta`, {
+      method: "POST",
+      body: JSON.stringify({ delta, kind, reference }),
+    })
+  },
+
+  getMovements: async (productId: string, limit?: number) => {
+    return apiCall<StockMovement[]>(`/inventory/stock/${productId}/movements${limit ? `?limit=${limit}` : ""}`)
+  },
+
+  // Batches the product's stock deltas in memory; picks beyond `headroom` per flush are refused
+  makeHot: async (productId: string, headroom: number) => {
+    return apiCall<{ message: string }>(`/inventory/stock/${productId}/hot`, {
+      method: "PUT",
+      body: JSON.stringify({ headroom }),
+    })
+  },
+
+  makeCold: async (productId: string) => {
+    return apiCall<{ message: string }>(`/inventory/stock/${productId}/hot`, { method: "DELETE" })
+  },
+
+  getHot: async () => {
+    return apiCall<HotStockStats[]>("/inventory/hot")
+  },
+
   getLowStock: async () => {
     return apiCall<Product[]>("/inventory/low-stock")
   },
@@ -241,6 +351,51 @@ export const inventoryApi = {
   },
 }
 
+// Live stock, product and alert changes pushed over /api/live
+export type LiveEvent =
+  | { type: "stock"; id: string; stock: number; threshold: number; status: Product["status"] }
+  | { type: "product"; product: Product }
+  | { type: "product-removed"; id: string }
+  | { type: "alerts"; product_id: string; alerts: InventoryAlert[] }
+  | { type: "alert-dismissed"; id: string }
+
+// Calls onEvents with each batch, or onResync when the page should refetch everything
+// (after a bulk change, a backlog, or a reconnect). Returns a function that closes the feed.
+export function subscribeLive(handlers: { onEvents: (events: LiveEvent[]) => void; onResync: () => void }) {
+  const url = API_BASE_URL.replace(/^http/, "ws") + "/live"
+  let socket: WebSocket | null = null
+  let closed = false
+  let retry: ReturnType<typeof setTimeout> | undefined
+  let reconnecting = false
+
+  const connect = () => {
+    socket = new WebSocket(url)
+    // Changes made while disconnected were missed
+    socket.onopen = () => {
+      if (reconnecting) handlers.onResync()
+    }
+    socket.onmessage = (message) => {
+      const frame = JSON.parse(message.data)
+      if (frame.resync) handlers.onResync()
+      else handlers.onEvents(frame.events)
+      // The server stops sending once too many frames go unacknowledged
+      socket?.send(JSON.stringify({ ack: frame.seq }))
+    }
+    socket.onclose = () => {
+      if (closed) return
+      reconnecting = true
+      retry = setTimeout(connect, 2000)
+    }
+  }
+  connect()
+
+  return () => {
+    closed = true
+    clearTimeout(retry)
+    socket?.close()
+  }
+}
+
 // Health check function
 export const healthCheck = async () => {
   return apiCall<{ status: string; timestamp: string }>("/health")